@@ -1,17 +1,102 @@
 #pragma once
 
+#include "csr_graph.hpp"
+#include "traversal_log.hpp"
+
 #include <vector>
 #include <utility>
+#include <algorithm>
+#include <cstddef>
 
-using AdjacencyMatrix = std::vector<std::vector<std::pair<float, int>>>;
+// Work done by the recorded (untimed) run, what an algorithm doesn't have (a queue, a notion of settling) stays at zero
+struct OperationCounters
+{
+	size_t Settled = 0; // Vertices scanned, label correcting algorithms can scan a vertex more than once
+	size_t Relaxations = 0; // Arcs looked at from a scanned vertex
+	size_t SuccessfulRelaxations = 0; // Arcs that lowered a distance or reached a vertex first
+	size_t QueuePushes = 0;
+	size_t QueuePops = 0; // Including stale entries that are skipped
+	size_t Reinsertions = 0; // Pushes of a vertex that had been queued before
+	size_t PeakQueueSize = 0;
+};
 
 struct TraversalResult
 {
-	std::vector<int> TraversedEdges;
+	// Edges in the order the recorded run first touched them, empty for the timed run
+	TraversalLog TraversedEdges;
 	std::vector<int> FinalEdges;
+	OperationCounters Counters;
+
+	// Path length as measured by the search itself, negative unless the algorithm works on approximated weights
+	float SearchDistance = -1.0f;
+
+	// Same as assigning an empty result, but the vectors keep their storage for the next query
+	void Clear()
+	{
+		TraversedEdges.Clear();
+		FinalEdges.clear();
+		Counters = {};
+		SearchDistance = -1.0f;
+	}
+};
+
+// Traversal recorder policies, every algorithm's search is templated on one of these.
+// The timed run uses NullRecorder so neither the visualization log nor the counters end up inside the measurement.
+struct NullRecorder
+{
+	static constexpr bool Enabled = false;
+
+	explicit NullRecorder(TraversalResult& result)
+	{
+		result.TraversedEdges.Clear();
+		result.Counters = {};
+		result.SearchDistance = -1.0f;
+	}
+
+	inline void Record(int) {}
+	inline void Settle() {}
+	inline void Relax(bool) {}
+	inline void Push(size_t, bool = false) {}
+	inline void Pop() {}
+};
+
+struct TraversalLogRecorder
+{
+	static constexpr bool Enabled = true;
+
+	explicit TraversalLogRecorder(TraversalResult& result)
+		: Log(result.TraversedEdges), Counters(result.Counters)
+	{
+		Log.Clear();
+		Counters = {};
+		result.SearchDistance = -1.0f;
+	}
+
+	inline void Record(int edge_index) { Log.Record(edge_index); }
+
+	inline void Settle() { Counters.Settled++; }
+
+	inline void Relax(bool improved)
+	{
+		Counters.Relaxations++;
+		Counters.SuccessfulRelaxations += improved;
+	}
+
+	// Called after every insertion into the queue, with the queue size after it
+	inline void Push(size_t queue_size, bool reinsertion = false)
+	{
+		Counters.QueuePushes++;
+		Counters.Reinsertions += reinsertion;
+		Counters.PeakQueueSize = std::max(Counters.PeakQueueSize, queue_size);
+	}
+
+	inline void Pop() { Counters.QueuePops++; }
+
+	TraversalLog& Log;
+	OperationCounters& Counters;
 };
 
-// Warning: modification of this requires modifying shader code
+// Warning: the line shader layout is derived from this, keep the GUI tables in main.cpp in sync when adding entries
 enum class AlgorithmType
 {
 	BFS,
@@ -21,11 +106,20 @@ enum class AlgorithmType
 	DEsopoPape,
 	BellmanFord,
 	FloydWarshall,
+	BidirectionalDijkstra,
+	AStar,
+	ALT,
+	ContractionHierarchies,
+	DijkstraIndexedHeap,
+	DijkstraRadixHeap,
+	DeltaStepping,
+	DirectionOptimizingBFS,
+	Johnson,
 
 	Count,
 };
 
-// Warning: modification of this requires modifying shader code
+// Sizes the per-algorithm vertex attributes and GUI tables
 static constexpr size_t AlgorithmTypeCount = (size_t)AlgorithmType::Count;
 
 class Algorithm
@@ -35,8 +129,32 @@ public:
 
 	virtual AlgorithmType GetName() const = 0;
 
-	// Everything in here will be timed
-	virtual void FindPath(const AdjacencyMatrix& graph, int start, int end) = 0;
+	// Everything in here will be timed, the traversal log is compiled out (NullRecorder)
+	virtual void FindPath(const CSRGraph& graph, int start, int end) = 0;
+
+	// Repeats the same search with the traversal log enabled (TraversalLogRecorder) for the visualization, this is not timed
+	virtual void RecordPath(const CSRGraph& graph, int start, int end) = 0;
+
+	// Query independent work on the graph such as landmark tables, run once per graph before any query and timed separately.
+	// Queries on a graph other than the one last preprocessed (by CSRGraph::Id) return an empty result, they neither
+	// preprocess inside the timed query nor use tables that belong to another graph.
+	virtual void Preprocess(const CSRGraph&) {}
+	virtual bool HasPreprocessing() const { return false; }
+
+	// Whether the tables from Preprocess belong to graph, always true for algorithms without preprocessing
+	virtual bool IsPreprocessedFor(const CSRGraph&) const { return true; }
+
+	// Memory kept alive by Preprocess for the queries
+	virtual size_t GetPreprocessedBytes() const { return 0; }
+
+	// Queries that are split across threads, the count can be changed between queries (0 picks the default).
+	// RecordPath may still run on one thread so the traversal log stays deterministic.
+	virtual bool IsMultithreaded() const { return false; }
+	virtual void SetThreadCount(unsigned) {}
+	virtual unsigned GetThreadCount() const { return 1; }
+
+	// Dense overload for callers that still hold a matrix, it is compressed on every call so prefer building a CSRGraph once
+	void FindPath(const AdjacencyMatrix& graph, int start, int end) { FindPath(CSRGraph::FromAdjacencyMatrix(graph), start, end); }
 
 	// This can do post processing to get the final path/result without affecting the running time.
 	virtual TraversalResult GetResult() = 0;
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "algorithm.hpp"
+#include "algorithms/BFS.hpp"
+#include "algorithms/DFS.hpp"
+#include "algorithms/DijkstraArray.hpp"
+#include "algorithms/DijkstraQueue.hpp"
+#include "algorithms/DEsopoPape.hpp"
+#include "algorithms/BellmanFord.hpp"
+#include "algorithms/FloydWarshall.hpp"
+#include "algorithms/BidirectionalDijkstra.hpp"
+#include "algorithms/AStar.hpp"
+#include "algorithms/ALT.hpp"
+#include "algorithms/ContractionHierarchies.hpp"
+#include "algorithms/DijkstraIndexedHeap.hpp"
+#include "algorithms/DijkstraRadixHeap.hpp"
+#include "algorithms/DeltaStepping.hpp"
+#include "algorithms/DirectionOptimizingBFS.hpp"
+#include "algorithms/Johnson.hpp"
+
+#include <memory>
+#include <string>
+
+// Stable identifiers for command line arguments and machine readable output (unlike the display names in the GUI)
+inline const char* AlgorithmTypeToIdentifier(const AlgorithmType type)
+{
+	switch (type)
+	{
+		case AlgorithmType::BFS:            return "BFS";
+		case AlgorithmType::DFS:            return "DFS";
+		case AlgorithmType::DijkstraArray:  return "DijkstraArray";
+		case AlgorithmType::DijkstraQueue:  return "DijkstraQueue";
+		case AlgorithmType::DEsopoPape:     return "DEsopoPape";
+		case AlgorithmType::BellmanFord:    return "BellmanFord";
+		case AlgorithmType::FloydWarshall:  return "FloydWarshall";
+		case AlgorithmType::BidirectionalDijkstra: return "BidirectionalDijkstra";
+		case AlgorithmType::AStar: return "AStar";
+		case AlgorithmType::ALT: return "ALT";
+		case AlgorithmType::ContractionHierarchies: return "ContractionHierarchies";
+		case AlgorithmType::DijkstraIndexedHeap: return "DijkstraIndexedHeap";
+		case AlgorithmType::DijkstraRadixHeap: return "DijkstraRadixHeap";
+		case AlgorithmType::DeltaStepping: return "DeltaStepping";
+		case AlgorithmType::DirectionOptimizingBFS: return "DirectionOptimizingBFS";
+		case AlgorithmType::Johnson: return "Johnson";
+		case AlgorithmType::Count:          break;
+	}
+
+	return "Unknown";
+}
+
+inline bool AlgorithmTypeFromIdentifier(const std::string& identifier, AlgorithmType& type)
+{
+	for (size_t index = 0; index < AlgorithmTypeCount; index++)
+	{
+		if (identifier == AlgorithmTypeToIdentifier((AlgorithmType)index))
+		{
+			type = (AlgorithmType)index;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+inline std::unique_ptr<Algorithm> CreateAlgorithm(const AlgorithmType type)
+{
+	switch (type)
+	{
+		case AlgorithmType::BFS:            return std::make_unique<BFS>();
+		case AlgorithmType::DFS:            return std::make_unique<DFS>();
+		case AlgorithmType::DijkstraArray:  return std::make_unique<DijkstraArray>();
+		case AlgorithmType::DijkstraQueue:  return std::make_unique<DijkstraQueue>();
+		case AlgorithmType::DEsopoPape:     return std::make_unique<DEsopoPape>();
+		case AlgorithmType::BellmanFord:    return std::make_unique<BellmanFord>();
+		case AlgorithmType::FloydWarshall:  return std::make_unique<FloydWarshall>();
+		case AlgorithmType::BidirectionalDijkstra: return std::make_unique<BidirectionalDijkstra>();
+		case AlgorithmType::AStar: return std::make_unique<AStar>();
+		case AlgorithmType::ALT: return std::make_unique<ALT>();
+		case AlgorithmType::ContractionHierarchies: return std::make_unique<ContractionHierarchies>();
+		case AlgorithmType::DijkstraIndexedHeap: return std::make_unique<DijkstraIndexedHeap>();
+		case AlgorithmType::DijkstraRadixHeap: return std::make_unique<DijkstraRadixHeap>();
+		case AlgorithmType::DeltaStepping: return std::make_unique<DeltaStepping>();
+		case AlgorithmType::DirectionOptimizingBFS: return std::make_unique<DirectionOptimizingBFS>();
+		case AlgorithmType::Johnson: return std::make_unique<Johnson>();
+		case AlgorithmType::Count:          break;
+	}
+
+	return nullptr;
+}
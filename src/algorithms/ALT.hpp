@@ -0,0 +1,266 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../parallel.hpp"
+#include "../search_workspace.hpp"
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <cmath>
+
+// A* with landmarks and the triangle inequality. Preprocess picks landmarks spread far apart and stores the shortest
+// distance from every landmark to every vertex, a query then uses max |d(L, end) - d(L, v)| over the landmarks as its
+// heuristic. The graph is undirected so one table serves as both the "to" and "from" distances.
+class ALT : public Algorithm {
+public:
+    static constexpr int DefaultLandmarkCount = 8;
+
+    explicit ALT(int landmark_count = DefaultLandmarkCount, unsigned thread_count = 0)
+        : m_LandmarkCount(landmark_count), m_ThreadCount(thread_count) {}
+
+    inline AlgorithmType GetName() const override { return AlgorithmType::ALT; }
+
+    void Preprocess(const CSRGraph& graph) override {
+        const int n = graph.GetVertexCount();
+
+        m_GraphId = graph.Id;
+        m_Landmarks = SelectLandmarks(graph);
+
+        const size_t k = m_Landmarks.size();
+        std::vector<std::vector<float>> rows(k);
+
+        // Each landmark is an independent full Dijkstra, so they run in parallel into their own rows
+        ParallelFor(k, m_ThreadCount, [&](size_t index) {
+            rows[index] = ShortestDistances(graph, m_Landmarks[index]);
+        });
+
+        // Stored vertex major, so the heuristic for one vertex reads a single contiguous run of k floats
+        m_Distances.resize((size_t)n * k);
+        for (int v = 0; v < n; ++v) {
+            for (size_t index = 0; index < k; ++index) {
+                m_Distances[(size_t)v * k + index] = rows[index][v];
+            }
+        }
+    }
+
+    bool HasPreprocessing() const override { return true; }
+
+    bool IsPreprocessedFor(const CSRGraph& graph) const override { return m_GraphId == graph.Id; }
+
+    size_t GetPreprocessedBytes() const override {
+        return m_Distances.size() * sizeof(float) + m_Landmarks.size() * sizeof(int);
+    }
+
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    // Farthest selection on hop counts: each new landmark is the vertex the most hops away from all the chosen ones.
+    // Unreached vertices count as infinitely far, so every connected component gets a landmark before any gets a second.
+    std::vector<int> SelectLandmarks(const CSRGraph& graph) const {
+        const int n = graph.GetVertexCount();
+        const int unreached = std::numeric_limits<int>::max();
+
+        std::vector<int> landmarks;
+        std::vector<int> nearest(n, unreached);
+        std::vector<int> hops(n);
+        std::vector<int> queue;
+        queue.reserve(n);
+
+        // Isolated vertices can never be on a path, so they are never picked
+        int candidates = 0;
+        for (int v = 0; v < n; ++v) {
+            if (graph.GetDegree(v) == 0) {
+                nearest[v] = 0;
+            }
+            else {
+                candidates++;
+            }
+        }
+
+        auto bfs = [&](int source) {
+            std::fill(hops.begin(), hops.end(), unreached);
+            queue.clear();
+            queue.push_back(source);
+            hops[source] = 0;
+
+            for (size_t head = 0; head < queue.size(); ++head) {
+                const int u = queue[head];
+                for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                    const int v = graph.Neighbors[i];
+                    if (hops[v] == unreached) {
+                        hops[v] = hops[u] + 1;
+                        queue.push_back(v);
+                    }
+                }
+            }
+        };
+
+        auto farthest = [&]() {
+            return (int)(std::max_element(nearest.begin(), nearest.end()) - nearest.begin());
+        };
+
+        const int count = std::min(m_LandmarkCount, candidates);
+        if (count <= 0) {
+            return landmarks;
+        }
+
+        // Start from the vertex farthest from an arbitrary one, rather than the arbitrary vertex itself
+        int seed = 0;
+        while (graph.GetDegree(seed) == 0) { seed++; }
+        bfs(seed);
+
+        int best = seed;
+        for (int v = 0; v < n; ++v) {
+            if (hops[v] != unreached && hops[v] > hops[best]) { best = v; }
+        }
+
+        while ((int)landmarks.size() < count) {
+            landmarks.push_back(best);
+            bfs(best);
+
+            for (int v = 0; v < n; ++v) {
+                nearest[v] = std::min(nearest[v], hops[v]);
+            }
+
+            best = farthest();
+            if (nearest[best] == 0) { break; }
+        }
+
+        return landmarks;
+    }
+
+    static std::vector<float> ShortestDistances(const CSRGraph& graph, int source) {
+        std::vector<float> dist(graph.GetVertexCount(), std::numeric_limits<float>::max());
+
+        using Element = std::pair<float, int>;
+        std::priority_queue<Element, std::vector<Element>, std::greater<Element>> pq;
+
+        dist[source] = 0.0f;
+        pq.push({0.0f, source});
+
+        while (!pq.empty()) {
+            const auto [d, u] = pq.top();
+            pq.pop();
+
+            if (d > dist[u]) { continue; }
+
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                const int v = graph.Neighbors[i];
+                const float alt = d + graph.Weights[i];
+                if (alt < dist[v]) {
+                    dist[v] = alt;
+                    pq.push({alt, v});
+                }
+            }
+        }
+
+        return dist;
+    }
+
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        // Distances to the landmarks of another graph can overestimate and give a suboptimal path, and quietly falling
+        // back to Dijkstra would report its time as ALT's, so the query fails instead
+        if (!IsPreprocessedFor(graph)) {
+            m_Result.Clear();
+            return;
+        }
+
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
+
+        int n = graph.GetVertexCount();
+        const float infinity = std::numeric_limits<float>::max();
+
+        const size_t k = m_Landmarks.size();
+        const float* end_distances = k > 0 ? &m_Distances[(size_t)end * k] : nullptr;
+
+        auto heuristic = [&](int v) {
+            float h = 0.0f;
+            if (k == 0) { return h; }
+
+            const float* v_distances = &m_Distances[(size_t)v * k];
+            for (size_t index = 0; index < k; ++index) {
+                if (v_distances[index] != infinity && end_distances[index] != infinity) {
+                    h = std::max(h, std::fabs(end_distances[index] - v_distances[index]));
+                }
+            }
+            return h;
+        };
+
+        SearchTree<float>& tree = m_Tree;
+        tree.Reset(n, infinity);
+
+        MinQueue<Element>& open = m_Open;
+        open.Clear();
+
+        const float start_h = heuristic(start);
+        tree.Update(start, 0.0f, -1, -1);
+        open.Push({start_h, start_h, 0.0f, start});
+        recorder.Push(open.Size());
+
+        while (!open.Empty()) {
+            const auto [f, h, g, u] = open.Top();
+            open.Pop();
+            recorder.Pop();
+
+            if (g > tree.GetDistance(u)) { continue; }
+            recorder.Settle();
+
+            if (u == end) {
+                tree.GetPathTo(end, m_Result.FinalEdges);
+                return;
+            }
+
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                const int v = graph.Neighbors[i];
+                const int edge_index = graph.EdgeIndices[i];
+                const float dist_v = tree.GetDistance(v);
+                float alt = g + graph.Weights[i];
+                recorder.Relax(alt < dist_v);
+
+                if (alt < dist_v) {
+                    const bool reinsertion = dist_v != infinity;
+                    tree.Update(v, alt, u, edge_index);
+
+                    const float v_h = heuristic(v);
+                    open.Push({alt + v_h, v_h, alt, v});
+                    recorder.Push(open.Size(), reinsertion);
+
+                    recorder.Record(edge_index);
+                }
+            }
+        }
+
+        m_Result.Clear();
+    }
+
+    // (f, h, g, vertex), ties on f go to the vertex closest to the end like AStar
+    using Element = std::tuple<float, float, float, int>;
+
+    int m_LandmarkCount;
+    unsigned m_ThreadCount;
+
+    uint64_t m_GraphId = 0;
+    std::vector<int> m_Landmarks;
+    std::vector<float> m_Distances;
+
+    SearchTree<float> m_Tree;
+    MinQueue<Element> m_Open;
+
+    TraversalResult m_Result;
+};
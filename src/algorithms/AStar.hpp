@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../search_workspace.hpp"
+#include <limits>
+#include <vector>
+#include <tuple>
+
+// A* with the straight line distance to the end as its heuristic, this needs the CSRGraph to carry vertex positions
+// and falls back to plain Dijkstra (a zero heuristic) when it doesn't.
+class AStar : public Algorithm {
+public:
+    inline AlgorithmType GetName() const override { return AlgorithmType::AStar; }
+
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
+
+        int n = graph.GetVertexCount();
+        const bool has_positions = graph.HasPositions();
+
+        SearchTree<float>& tree = m_Tree;
+        tree.Reset(n, std::numeric_limits<float>::max());
+
+        MinQueue<Element>& open = m_Open;
+        open.Clear();
+
+        const float start_h = has_positions ? graph.StraightLineDistance(start, end) : 0.0f;
+        tree.Update(start, 0.0f, -1, -1);
+        open.Push({start_h, start_h, 0.0f, start});
+        recorder.Push(open.Size());
+
+        while (!open.Empty()) {
+            const auto [f, h, g, u] = open.Top();
+            open.Pop();
+            recorder.Pop();
+
+            if (g > tree.GetDistance(u)) { continue; }
+            recorder.Settle();
+
+            if (u == end) {
+                tree.GetPathTo(end, m_Result.FinalEdges);
+                return;
+            }
+
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                const int v = graph.Neighbors[i];
+                const int edge_index = graph.EdgeIndices[i];
+                const float dist_v = tree.GetDistance(v);
+                float alt = g + graph.Weights[i];
+                recorder.Relax(alt < dist_v);
+
+                if (alt < dist_v) {
+                    // The heuristic is consistent, so like in Dijkstra a vertex with a distance is still open and its entry goes stale
+                    const bool reinsertion = dist_v != std::numeric_limits<float>::max();
+                    tree.Update(v, alt, u, edge_index);
+
+                    const float v_h = has_positions ? graph.StraightLineDistance(v, end) : 0.0f;
+                    open.Push({alt + v_h, v_h, alt, v});
+                    recorder.Push(open.Size(), reinsertion);
+
+                    recorder.Record(edge_index);
+                }
+            }
+        }
+
+        m_Result.Clear();
+    }
+
+    // (f, h, g, vertex), equal f values pop the vertex closest to the end first so ties are broken towards the target
+    using Element = std::tuple<float, float, float, int>;
+
+    SearchTree<float> m_Tree;
+    MinQueue<Element> m_Open;
+
+    TraversalResult m_Result;
+};
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "../algorithm.hpp"
+#include "../search_workspace.hpp"
 #include <cstdio>
-#include <queue>
 #include <vector>
 #include <algorithm>
 
@@ -11,60 +11,78 @@ class BFS : public Algorithm
 public:
 	inline AlgorithmType GetName() const override { return AlgorithmType::BFS; }
 
-	void FindPath(const AdjacencyMatrix& graph, int start, int end) override
+	void FindPath(const CSRGraph& graph, int start, int end) override
 	{
-		std::queue<int> queue;
-		std::vector<bool> visited(graph.size(), false);
+		Search<NullRecorder>(graph, start, end);
+	}
+
+	void RecordPath(const CSRGraph& graph, int start, int end) override
+	{
+		Search<TraversalLogRecorder>(graph, start, end);
+	}
+
+	TraversalResult GetResult() override
+	{
+		return m_Result;
+	}
+
+private:
+	template <typename Recorder>
+	void Search(const CSRGraph& graph, int start, int end)
+	{
+		Recorder recorder(m_Result);
+		m_Result.FinalEdges.clear();
 
-		std::vector<int> parent(graph.size(), -1);
-		std::vector<int> parentEdge(graph.size(), -1);
+		const int n = graph.GetVertexCount();
 
-		visited[start] = true;
-		queue.push(start);
+		// Hop counts as distances, a vertex is visited once it is in the tree
+		SearchTree<int>& tree = m_Tree;
+		tree.Reset(n, -1);
 
-		while (!queue.empty())
+		// Every vertex is queued at most once, so the queue is a vector read from the front
+		std::vector<int>& queue = m_Queue;
+		queue.clear();
+		queue.reserve(n);
+
+		tree.Update(start, 0, -1, -1);
+		queue.push_back(start);
+		recorder.Push(queue.size());
+
+		for (size_t head = 0; head < queue.size(); head++)
 		{
-			int curr = queue.front();
-			queue.pop();
+			int curr = queue[head];
+			recorder.Pop();
+			recorder.Settle();
 
 			if (curr == end)
 			{
-				std::vector<int> edges;
-				int node = end;
-
-				while (parent[node] != -1) {
-					edges.push_back(parentEdge[node]);
-					node = parent[node];
-				}
-
-				std::reverse(edges.begin(), edges.end());
-				m_Result.FinalEdges = std::move(edges);
+				tree.GetPathTo(end, m_Result.FinalEdges);
 				return;
 			}
 
-			for (size_t i = 0; i < graph.size(); i++)
+			const int hops = tree.GetDistance(curr) + 1;
+			for (int i = graph.Offsets[curr]; i < graph.Offsets[curr + 1]; i++)
 			{
-				const auto [weight, edge_index] = graph[curr][i];
-				if (!visited[i] && weight > 0.0f)
+				const int v = graph.Neighbors[i];
+				const int edge_index = graph.EdgeIndices[i];
+				recorder.Relax(!tree.IsReached(v));
+
+				if (!tree.IsReached(v))
 				{
-					visited[i] = true;
-					parent[i] = curr;
-					parentEdge[i] = edge_index;
-					queue.push(i);
+					tree.Update(v, hops, curr, edge_index);
+					queue.push_back(v);
+					recorder.Push(queue.size() - head - 1);
 
-					m_Result.TraversedEdges.push_back(edge_index);
+					recorder.Record(edge_index);
 				}
 			}
 		}
 
-		m_Result = {};
+		m_Result.Clear();
 	}
 
-	TraversalResult GetResult() override
-	{
-		return m_Result;
-	}
+	SearchTree<int> m_Tree;
+	std::vector<int> m_Queue;
 
-private:
 	TraversalResult m_Result;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../algorithm.hpp"
+#include "../search_workspace.hpp"
 #include <vector>
 #include <limits>
 #include <algorithm>
@@ -9,36 +10,51 @@ class BellmanFord : public Algorithm {
 public:
     inline AlgorithmType GetName() const override { return AlgorithmType::BellmanFord; }
 
-    void FindPath(const AdjacencyMatrix& graph, int start, int end) override {
-        int n = graph.size();
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
+
+        int n = graph.GetVertexCount();
 
-        std::vector<float> dist(n, std::numeric_limits<float>::max());
-        std::vector<int> parent(n, -1);
-        std::vector<int> parent_edge(n, -1);
+        const float infinity = std::numeric_limits<float>::max();
 
-        dist[start] = 0.0f;
+        SearchTree<float>& tree = m_Tree;
+        tree.Reset(n, infinity);
+        tree.Update(start, 0.0f, -1, -1);
 
-        for (int i = 0; i < n - 1; i++) {
+        for (int pass = 0; pass < n - 1; pass++) {
             bool changed = false;
 
             for (int u = 0; u < n; u++) {
-                if (dist[u] == std::numeric_limits<float>::max()) { continue; }
+                if (!tree.IsReached(u)) { continue; }
+                recorder.Settle();
 
-                for (int v = 0; v < n; v++) {
-                    const auto [weight, edge_index] = graph[u][v];
+                for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; i++) {
+                    const int v = graph.Neighbors[i];
+                    const int edge_index = graph.EdgeIndices[i];
+                    float alt = tree.GetDistance(u) + graph.Weights[i];
+                    recorder.Relax(alt < tree.GetDistance(v));
 
-                    if (weight != 0.0f) {
-                        float alt = dist[u] + weight;
+                    if (alt < tree.GetDistance(v)) {
+                        tree.Update(v, alt, u, edge_index);
 
-                        if (alt < dist[v]) {
-                            dist[v] = alt;
-                            parent[v] = u;
-                            parent_edge[v] = edge_index;
+                        recorder.Record(edge_index);
 
-                            m_Result.TraversedEdges.push_back(edge_index);
-
-                            changed = true;
-                        }
+                        changed = true;
                     }
                 }
             }
@@ -47,41 +63,25 @@ public:
         }
 
         for (int u = 0; u < n; u++) {
-            if (dist[u] == std::numeric_limits<float>::max()) { continue; }
-
-            for (int v = 0; v < n; v++) {
-                const auto [weight, edge_index] = graph[u][v];
+            if (!tree.IsReached(u)) { continue; }
 
-                if (weight != 0.0f) {
-                    if (dist[u] + weight < dist[v]) {
-                        m_Result = {};
-                        return;
-                    }
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; i++) {
+                if (tree.GetDistance(u) + graph.Weights[i] < tree.GetDistance(graph.Neighbors[i])) {
+                    m_Result.Clear();
+                    return;
                 }
             }
         }
 
-        if (dist[end] == std::numeric_limits<float>::max()) {
-            m_Result = {};
+        if (!tree.IsReached(end)) {
+            m_Result.Clear();
             return;
         }
 
-        std::vector<int> edges;
-        int node = end;
-
-        while (parent[node] != -1) {
-            edges.push_back(parent_edge[node]);
-            node = parent[node];
-        }
-
-        std::reverse(edges.begin(), edges.end());
-        m_Result.FinalEdges = std::move(edges);
+        tree.GetPathTo(end, m_Result.FinalEdges);
     }
 
-    TraversalResult GetResult() override {
-        return m_Result;
-    }
+    SearchTree<float> m_Tree;
 
-private:
     TraversalResult m_Result;
 };
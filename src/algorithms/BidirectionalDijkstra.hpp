@@ -0,0 +1,121 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../search_workspace.hpp"
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+// Runs Dijkstra forward from the start and backward from the end at the same time, always expanding the frontier with the
+// smaller key. Both searches log into the same traversal log, so the playback grows a ball around each pin.
+class BidirectionalDijkstra : public Algorithm {
+public:
+    inline AlgorithmType GetName() const override { return AlgorithmType::BidirectionalDijkstra; }
+
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
+
+        if (start == end) {
+            return;
+        }
+
+        int n = graph.GetVertexCount();
+        const float infinity = std::numeric_limits<float>::max();
+
+        // Index 0 is the forward search from start, index 1 the backward search from end (the graph is undirected)
+        SearchTree<float>* tree = m_Trees;
+        MinQueue<Element>* pq = m_Queues;
+        for (int side = 0; side < 2; ++side) {
+            tree[side].Reset(n, infinity);
+            pq[side].Clear();
+        }
+
+        tree[0].Update(start, 0.0f, -1, -1);
+        tree[1].Update(end, 0.0f, -1, -1);
+        pq[0].Push({0.0f, start});
+        recorder.Push(pq[0].Size() + pq[1].Size());
+        pq[1].Push({0.0f, end});
+        recorder.Push(pq[0].Size() + pq[1].Size());
+
+        // Length of the best start-end path seen so far, and the edge joining the two search trees on it
+        float best = infinity;
+        int meet_forward = -1;
+        int meet_backward = -1;
+        int meet_edge = -1;
+
+        while (!pq[0].Empty() && !pq[1].Empty()) {
+            // Every path not seen yet is at least as long as the two smallest keys combined
+            if (pq[0].Top().first + pq[1].Top().first >= best) { break; }
+
+            const int side = pq[0].Top().first <= pq[1].Top().first ? 0 : 1;
+            const int other = 1 - side;
+
+            float d = pq[side].Top().first;
+            int u = pq[side].Top().second;
+            pq[side].Pop();
+            recorder.Pop();
+
+            if (d > tree[side].GetDistance(u)) { continue; }
+            recorder.Settle();
+
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                const int v = graph.Neighbors[i];
+                const int edge_index = graph.EdgeIndices[i];
+                const float dist_v = tree[side].GetDistance(v);
+                float alt = d + graph.Weights[i];
+                recorder.Relax(alt < dist_v);
+
+                if (alt < dist_v) {
+                    const bool reinsertion = dist_v != infinity;
+                    tree[side].Update(v, alt, u, edge_index);
+
+                    pq[side].Push({alt, v});
+                    recorder.Push(pq[0].Size() + pq[1].Size(), reinsertion);
+
+                    recorder.Record(edge_index);
+                }
+
+                const float other_v = tree[other].GetDistance(v);
+                if (other_v != infinity && alt + other_v < best) {
+                    best = alt + other_v;
+                    meet_forward = side == 0 ? u : v;
+                    meet_backward = side == 0 ? v : u;
+                    meet_edge = edge_index;
+                }
+            }
+        }
+
+        if (meet_edge == -1) {
+            m_Result.Clear();
+            return;
+        }
+
+        std::vector<int>& edges = m_Result.FinalEdges;
+        tree[0].GetPathTo(meet_forward, edges);
+        edges.push_back(meet_edge);
+        tree[1].AppendEdgesToRoot(meet_backward, edges);
+    }
+
+    using Element = std::pair<float, int>;
+
+    SearchTree<float> m_Trees[2];
+    MinQueue<Element> m_Queues[2];
+
+    TraversalResult m_Result;
+};
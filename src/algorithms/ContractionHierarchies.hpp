@@ -0,0 +1,408 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../search_workspace.hpp"
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+
+// Contraction Hierarchies. Preprocess contracts the vertices one at a time in order of edge difference plus deleted
+// neighbours, adding a shortcut between two neighbours whenever a witness search finds no path avoiding the contracted
+// vertex that is as short. A query is a bidirectional Dijkstra that only ever relaxes arcs towards higher ranked vertices,
+// and the shortcuts on the resulting path are unpacked back into the original edges.
+class ContractionHierarchies : public Algorithm {
+public:
+    // Witness searches give up after settling this many vertices, which can only add unnecessary shortcuts, never miss one
+    static constexpr int DefaultWitnessSettleLimit = 64;
+
+    explicit ContractionHierarchies(int witness_settle_limit = DefaultWitnessSettleLimit)
+        : m_WitnessSettleLimit(witness_settle_limit) {}
+
+    inline AlgorithmType GetName() const override { return AlgorithmType::ContractionHierarchies; }
+
+    void Preprocess(const CSRGraph& graph) override {
+        const int n = graph.GetVertexCount();
+
+        m_GraphId = graph.Id;
+        m_Shortcuts.clear();
+
+        // Working copy of the graph that only keeps arcs between vertices that are still uncontracted
+        m_Adjacency.assign(n, {});
+        for (int u = 0; u < n; ++u) {
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                AddArc(u, { graph.Neighbors[i], graph.Weights[i], graph.EdgeIndices[i] });
+            }
+        }
+
+        m_WitnessDist.assign(n, std::numeric_limits<float>::max());
+        m_WitnessTouched.clear();
+        m_WitnessTargets.assign(n, 0);
+        m_WitnessStamp = 0;
+        m_Contracted.assign(n, false);
+
+        std::vector<int> deleted_neighbors(n, 0);
+        std::vector<int> priority(n);
+
+        using Element = std::pair<int, int>;
+        std::priority_queue<Element, std::vector<Element>, std::greater<Element>> order;
+
+        for (int v = 0; v < n; ++v) {
+            priority[v] = ContractionPriority(v, deleted_neighbors[v]);
+            order.push({priority[v], v});
+        }
+
+        std::vector<std::vector<Arc>> upward(n);
+        std::vector<Arc> shortcuts;
+
+        while (!order.empty()) {
+            const auto [p, v] = order.top();
+            order.pop();
+
+            if (m_Contracted[v] || p != priority[v]) { continue; }
+
+            // Lazy update: the priority may have gone stale since it was queued, so only contract if it is still the minimum
+            priority[v] = ContractionPriority(v, deleted_neighbors[v]);
+            if (!order.empty() && priority[v] > order.top().first) {
+                order.push({priority[v], v});
+                continue;
+            }
+
+            FindShortcuts(v, m_WitnessSettleLimit, shortcuts);
+
+            m_Contracted[v] = true;
+
+            // Every arc left on v leads to a vertex that will be contracted later, so these are exactly its upward arcs
+            upward[v] = std::move(m_Adjacency[v]);
+            m_Adjacency[v].clear();
+
+            for (const Arc& arc : upward[v]) {
+                RemoveArc(arc.Target, v);
+            }
+
+            for (const Arc& shortcut : shortcuts) {
+                const Shortcut& s = m_Shortcuts[DecodeShortcut(shortcut.Id)];
+                AddArc(s.From, { s.To, shortcut.Weight, shortcut.Id });
+                AddArc(s.To, { s.From, shortcut.Weight, shortcut.Id });
+            }
+
+            // Only the deleted neighbours term is bumped here, the edge difference is refreshed by the lazy update on pop.
+            // Re-simulating every neighbour after each contraction dominates preprocessing once the core gets dense.
+            for (const Arc& arc : upward[v]) {
+                deleted_neighbors[arc.Target]++;
+                priority[arc.Target]++;
+                order.push({priority[arc.Target], arc.Target});
+            }
+        }
+
+        // Flatten the upward arcs into CSR form for the queries
+        m_UpOffsets.assign(n + 1, 0);
+        m_UpArcs.clear();
+        for (int v = 0; v < n; ++v) {
+            m_UpArcs.insert(m_UpArcs.end(), upward[v].begin(), upward[v].end());
+            m_UpOffsets[v + 1] = (int)m_UpArcs.size();
+        }
+
+        m_Adjacency.clear();
+        m_Adjacency.shrink_to_fit();
+        m_WitnessDist.clear();
+        m_WitnessDist.shrink_to_fit();
+        m_WitnessTargets.clear();
+        m_WitnessTargets.shrink_to_fit();
+        m_Contracted.clear();
+        m_Contracted.shrink_to_fit();
+    }
+
+    bool HasPreprocessing() const override { return true; }
+
+    bool IsPreprocessedFor(const CSRGraph& graph) const override { return m_GraphId == graph.Id; }
+
+    size_t GetPreprocessedBytes() const override {
+        return m_UpOffsets.size() * sizeof(int) + m_UpArcs.size() * sizeof(Arc)
+            + m_Shortcuts.size() * sizeof(Shortcut);
+    }
+
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    // Arc ids are original edge indices when non-negative, and ~shortcut_index for shortcuts
+    struct Arc {
+        int Target;
+        float Weight;
+        int Id;
+    };
+
+    // A shortcut From - Via - To, made of the arcs From - Via and Via - To
+    struct Shortcut {
+        int From;
+        int Via;
+        int To;
+        int First;
+        int Second;
+    };
+
+    static bool IsShortcut(int id) { return id < 0; }
+    static int DecodeShortcut(int id) { return ~id; }
+
+    // Keeps only the shortest arc between two vertices
+    void AddArc(int u, const Arc& arc) {
+        for (Arc& existing : m_Adjacency[u]) {
+            if (existing.Target == arc.Target) {
+                if (arc.Weight < existing.Weight) { existing = arc; }
+                return;
+            }
+        }
+
+        m_Adjacency[u].push_back(arc);
+    }
+
+    void RemoveArc(int u, int target) {
+        auto& arcs = m_Adjacency[u];
+        arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [target](const Arc& arc) { return arc.Target == target; }), arcs.end());
+    }
+
+    // Dijkstra from source over the uncontracted vertices, never entering via. It stops once every vertex marked with the
+    // current target stamp is settled, past max_dist, or at the settle limit.
+    void WitnessSearch(int source, int via, float max_dist, int target_count, int settle_limit) {
+        for (int v : m_WitnessTouched) { m_WitnessDist[v] = std::numeric_limits<float>::max(); }
+        m_WitnessTouched.clear();
+
+        // The heap storage is reused across the many small searches of a preprocessing run
+        auto& heap = m_WitnessHeap;
+        heap.clear();
+
+        m_WitnessDist[source] = 0.0f;
+        m_WitnessTouched.push_back(source);
+        heap.push_back({0.0f, source});
+
+        int settled = 0;
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+            const auto [d, u] = heap.back();
+            heap.pop_back();
+
+            if (d > m_WitnessDist[u]) { continue; }
+            if (d > max_dist || ++settled > settle_limit) { break; }
+            if (m_WitnessTargets[u] == m_WitnessStamp && --target_count == 0) { break; }
+
+            for (const Arc& arc : m_Adjacency[u]) {
+                if (arc.Target == via) { continue; }
+
+                const float alt = d + arc.Weight;
+                if (alt < m_WitnessDist[arc.Target]) {
+                    if (m_WitnessDist[arc.Target] == std::numeric_limits<float>::max()) {
+                        m_WitnessTouched.push_back(arc.Target);
+                    }
+
+                    m_WitnessDist[arc.Target] = alt;
+                    heap.push_back({alt, arc.Target});
+                    std::push_heap(heap.begin(), heap.end(), std::greater<>());
+                }
+            }
+        }
+    }
+
+    // Collects the shortcuts contracting v would need, the pair u < w is only checked from u as the graph is undirected
+    void FindShortcuts(int v, int settle_limit, std::vector<Arc>& shortcuts) {
+        shortcuts.clear();
+
+        const auto& arcs = m_Adjacency[v];
+        for (size_t i = 0; i < arcs.size(); ++i) {
+            float max_dist = 0.0f;
+            for (size_t j = i + 1; j < arcs.size(); ++j) {
+                max_dist = std::max(max_dist, arcs[i].Weight + arcs[j].Weight);
+            }
+
+            if (max_dist == 0.0f) { continue; }
+
+            m_WitnessStamp++;
+            for (size_t j = i + 1; j < arcs.size(); ++j) {
+                m_WitnessTargets[arcs[j].Target] = m_WitnessStamp;
+            }
+
+            WitnessSearch(arcs[i].Target, v, max_dist, (int)(arcs.size() - i - 1), settle_limit);
+
+            for (size_t j = i + 1; j < arcs.size(); ++j) {
+                const float through_v = arcs[i].Weight + arcs[j].Weight;
+                if (m_WitnessDist[arcs[j].Target] <= through_v) { continue; }
+
+                const int id = ~(int)m_Shortcuts.size();
+                m_Shortcuts.push_back({ arcs[i].Target, v, arcs[j].Target, arcs[i].Id, arcs[j].Id });
+                shortcuts.push_back({ arcs[j].Target, through_v, id });
+            }
+        }
+    }
+
+    // Edge difference (shortcuts added minus arcs removed) plus the number of already contracted neighbours
+    int ContractionPriority(int v, int deleted_neighbors) {
+        const size_t shortcut_count = m_Shortcuts.size();
+
+        // The estimate only steers the order, so it gets by with a much smaller search than the real contraction
+        std::vector<Arc>& shortcuts = m_PriorityShortcuts;
+        FindShortcuts(v, std::max(1, m_WitnessSettleLimit / 4), shortcuts);
+
+        // This was only a simulation, drop the shortcut records it created
+        m_Shortcuts.resize(shortcut_count);
+
+        return (int)shortcuts.size() - (int)m_Adjacency[v].size() + deleted_neighbors;
+    }
+
+    // Appends the original edges of an arc, walking it from the vertex from
+    void Unpack(int id, int from, std::vector<int>& edges) const {
+        if (!IsShortcut(id)) {
+            edges.push_back(id);
+            return;
+        }
+
+        const Shortcut& s = m_Shortcuts[DecodeShortcut(id)];
+        if (from == s.From) {
+            Unpack(s.First, s.From, edges);
+            Unpack(s.Second, s.Via, edges);
+        }
+        else {
+            Unpack(s.Second, s.To, edges);
+            Unpack(s.First, s.Via, edges);
+        }
+    }
+
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        // The upward search is meaningless without a hierarchy for this graph
+        if (!IsPreprocessedFor(graph)) {
+            m_Result.Clear();
+            return;
+        }
+
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
+
+        if (start == end) {
+            return;
+        }
+
+        int n = graph.GetVertexCount();
+        const float infinity = std::numeric_limits<float>::max();
+
+        // Index 0 is the upward search from start, index 1 the upward search from end. Parent edges hold arc ids.
+        SearchTree<float>* tree = m_Trees;
+        MinQueue<Element>* pq = m_Queues;
+        for (int side = 0; side < 2; ++side) {
+            tree[side].Reset(n, infinity);
+            pq[side].Clear();
+        }
+
+        tree[0].Update(start, 0.0f, -1, -1);
+        tree[1].Update(end, 0.0f, -1, -1);
+        pq[0].Push({0.0f, start});
+        recorder.Push(pq[0].Size() + pq[1].Size());
+        pq[1].Push({0.0f, end});
+        recorder.Push(pq[0].Size() + pq[1].Size());
+
+        float best = infinity;
+        int meet = -1;
+
+        // Unlike plain bidirectional Dijkstra the searches can't stop when the two keys sum past the best path, as the
+        // upward graphs don't meet in the middle. Each side runs until its own smallest key reaches the best path.
+        while (true) {
+            const bool forward_open = !pq[0].Empty() && pq[0].Top().first < best;
+            const bool backward_open = !pq[1].Empty() && pq[1].Top().first < best;
+            if (!forward_open && !backward_open) { break; }
+
+            const int side = forward_open && (!backward_open || pq[0].Top().first <= pq[1].Top().first) ? 0 : 1;
+            const int other = 1 - side;
+
+            const auto [d, u] = pq[side].Top();
+            pq[side].Pop();
+            recorder.Pop();
+
+            if (d > tree[side].GetDistance(u)) { continue; }
+            recorder.Settle();
+
+            const float other_u = tree[other].GetDistance(u);
+            if (other_u != infinity && d + other_u < best) {
+                best = d + other_u;
+                meet = u;
+            }
+
+            for (int i = m_UpOffsets[u]; i < m_UpOffsets[u + 1]; ++i) {
+                const Arc& arc = m_UpArcs[i];
+                const float dist_target = tree[side].GetDistance(arc.Target);
+                const float alt = d + arc.Weight;
+                recorder.Relax(alt < dist_target);
+
+                if (alt < dist_target) {
+                    const bool reinsertion = dist_target != infinity;
+                    tree[side].Update(arc.Target, alt, u, arc.Id);
+
+                    pq[side].Push({alt, arc.Target});
+                    recorder.Push(pq[0].Size() + pq[1].Size(), reinsertion);
+
+                    if constexpr (Recorder::Enabled) {
+                        m_UnpackedEdges.clear();
+                        Unpack(arc.Id, u, m_UnpackedEdges);
+                        for (int edge_index : m_UnpackedEdges) { recorder.Record(edge_index); }
+                    }
+                }
+            }
+        }
+
+        if (meet == -1) {
+            m_Result.Clear();
+            return;
+        }
+
+        std::vector<int>& edges = m_Result.FinalEdges;
+
+        std::vector<int>& forward_nodes = m_PathNodes;
+        forward_nodes.clear();
+        for (int node = meet; tree[0].GetParent(node) != -1; node = tree[0].GetParent(node)) {
+            forward_nodes.push_back(node);
+        }
+
+        for (auto it = forward_nodes.rbegin(); it != forward_nodes.rend(); ++it) {
+            Unpack(tree[0].GetParentEdge(*it), tree[0].GetParent(*it), edges);
+        }
+
+        for (int node = meet; tree[1].GetParent(node) != -1; node = tree[1].GetParent(node)) {
+            Unpack(tree[1].GetParentEdge(node), node, edges);
+        }
+    }
+
+    using Element = std::pair<float, int>;
+
+    int m_WitnessSettleLimit;
+
+    uint64_t m_GraphId = 0;
+    std::vector<int> m_UpOffsets;
+    std::vector<Arc> m_UpArcs;
+    std::vector<Shortcut> m_Shortcuts;
+
+    // Preprocessing scratch, released once the hierarchy is built
+    std::vector<std::vector<Arc>> m_Adjacency;
+    std::vector<float> m_WitnessDist;
+    std::vector<int> m_WitnessTouched;
+    std::vector<int> m_WitnessTargets;
+    std::vector<std::pair<float, int>> m_WitnessHeap;
+    int m_WitnessStamp = 0;
+    std::vector<bool> m_Contracted;
+    std::vector<Arc> m_PriorityShortcuts;
+
+    SearchTree<float> m_Trees[2];
+    MinQueue<Element> m_Queues[2];
+    std::vector<int> m_PathNodes;
+    std::vector<int> m_UnpackedEdges;
+
+    TraversalResult m_Result;
+};
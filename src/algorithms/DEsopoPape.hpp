@@ -1,8 +1,8 @@
 #pragma once
 
 #include "../algorithm.hpp"
+#include "../search_workspace.hpp"
 #include <vector>
-#include <deque>
 #include <limits>
 #include <algorithm>
 
@@ -10,73 +10,88 @@ class DEsopoPape : public Algorithm {
 public:
     inline AlgorithmType GetName() const override { return AlgorithmType::DEsopoPape; }
 
-    void FindPath(const AdjacencyMatrix& graph, int start, int end) override {
-        int n = graph.size();
-        std::vector<int> state(n, 2);
-        std::vector<float> dist(n, std::numeric_limits<float>::max());
-        std::vector<int> parent(n, -1);
-        std::vector<int> parent_edge(n, -1);
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
 
-        std::deque<int> q;
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
 
-        dist[start] = 0.0f;
-        state[start] = 1;
-        q.push_back(start);
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
 
-        while (!q.empty()) {
-            int u = q.front();
-            q.pop_front();
+private:
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
 
-            state[u] = 0;
+        int n = graph.GetVertexCount();
+        // 2 never queued, 1 in the queue, 0 scanned and out of it
+        EpochArray<char>& state = m_State;
+        state.Reset(n, 2);
 
-            if (u == end) {
-                std::vector<int> edges;
-                int node = end;
+        SearchTree<float>& tree = m_Tree;
+        tree.Reset(n, std::numeric_limits<float>::max());
 
-                while (parent[node] != -1) {
-                    edges.push_back(parent_edge[node]);
-                    node = parent[node];
-                }
+        // A vertex is only pushed while it isn't in the queue, so the queue never holds more than n entries
+        BoundedDeque& q = m_Queue;
+        q.Reset(n);
 
-                std::reverse(edges.begin(), edges.end());
-                m_Result.FinalEdges = std::move(edges);
-                return;
-            }
+        tree.Update(start, 0.0f, -1, -1);
+        state.Set(start, 1);
+        q.PushBack(start);
+        recorder.Push(q.Size());
 
-            for (int v = 0; v < n; v++) {
-                const auto [weight, edge_index] = graph[u][v];
+        while (!q.Empty()) {
+            int u = q.Front();
+            q.PopFront();
+            recorder.Pop();
 
-                if (weight > 0.0f) {
-                    float alt = dist[u] + weight;
+            state.Set(u, 0);
+            recorder.Settle();
 
-                    if (alt < dist[v]) {
-                        dist[v] = alt;
-                        parent[v] = u;
-                        parent_edge[v] = edge_index;
+            if (u == end) {
+                tree.GetPathTo(end, m_Result.FinalEdges);
+                return;
+            }
 
-                        m_Result.TraversedEdges.push_back(edge_index);
+            const float dist_u = tree.GetDistance(u);
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; i++) {
+                const int v = graph.Neighbors[i];
+                const int edge_index = graph.EdgeIndices[i];
+                float alt = dist_u + graph.Weights[i];
+                recorder.Relax(alt < tree.GetDistance(v));
 
-                        if (state[v] == 2) {
-                            state[v] = 1;
-                            q.push_back(v);
-                        }
-                        else if (state[v] == 0) {
-                            state[v] = 1;
-                            q.push_front(v);
-                        }
+                if (alt < tree.GetDistance(v)) {
+                    tree.Update(v, alt, u, edge_index);
 
+                    recorder.Record(edge_index);
+
+                    const char v_state = state.Get(v);
+                    if (v_state == 2) {
+                        state.Set(v, 1);
+                        q.PushBack(v);
+                        recorder.Push(q.Size());
+                    }
+                    else if (v_state == 0) {
+                        state.Set(v, 1);
+                        q.PushFront(v);
+                        recorder.Push(q.Size(), true);
                     }
+
                 }
             }
         }
 
-        m_Result = {};
+        m_Result.Clear();
     }
 
-    TraversalResult GetResult() override {
-        return m_Result;
-    }
+    EpochArray<char> m_State;
+    SearchTree<float> m_Tree;
+    BoundedDeque m_Queue;
 
-private:
     TraversalResult m_Result;
 };
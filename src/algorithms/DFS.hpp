@@ -1,36 +1,17 @@
 #pragma once
 
 #include "../algorithm.hpp"
+#include "../search_workspace.hpp"
 #include <vector>
 
-static bool dfs(const AdjacencyMatrix &graph, std::vector<bool> &visited, int curr, int end, std::vector<int> &res, std::vector<int> &s, int index) {
-    if (curr == end) {
-        return true;
-    }
-    visited[curr] = true;
-    res.push_back(index);
-    s.push_back(index);
-    for (size_t i = 0; i < graph.size(); i++) {
-        if (!visited[i] && graph[curr][i].first > 0.0f) {
-            if (dfs(graph, visited, i, end, res, s, graph[curr][i].second)) {
-                res.push_back(graph[curr][i].second);
-                s.push_back(graph[curr][i].second);
-                return true;
-            }
-        }
-    }
-    s.pop_back();
-    return false;
-}
-
 class DFS : public Algorithm {
 public:
-    void FindPath(const AdjacencyMatrix& graph, int start, int end) override {
-        std::vector<int> path, s;
-        std::vector<bool> visited(graph.size(), false);
-        dfs(graph, visited, start, end, path, s, start);
-        m_Result.TraversedEdges = path;
-        m_Result.FinalEdges = s;
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
     }
 
     inline AlgorithmType GetName() const override { return AlgorithmType::DFS; }
@@ -39,5 +20,77 @@ public:
 		return m_Result;
 	}
 private:
+    // One level of the search: the vertex and the next of its arcs to try
+    struct Frame {
+        int Vertex;
+        int Cursor;
+    };
+
+    // Iterative depth first search on an explicit stack, so long chains don't grow the call stack. The log and the path
+    // are the ones the recursive version produced: every vertex records the arc it was entered through on entry (start
+    // records itself), and once end is reached every open frame records the arc it descended through, innermost first.
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        Recorder path(m_Result);
+        std::vector<int>& s = m_Result.FinalEdges;
+        s.clear();
+
+        if (start == end) {
+            return;
+        }
+
+        const int n = graph.GetVertexCount();
+        m_Visited.Reset(n);
+        m_Frames.clear();
+        m_Frames.reserve(n);
+
+        m_Visited.Insert(start);
+        path.Record(start);
+        s.push_back(start);
+        m_Frames.push_back({ start, graph.Offsets[start] });
+        path.Push(m_Frames.size());
+        path.Settle();
+
+        while (!m_Frames.empty()) {
+            Frame& top = m_Frames.back();
+
+            if (top.Cursor == graph.Offsets[top.Vertex + 1]) {
+                s.pop_back();
+                m_Frames.pop_back();
+                path.Pop();
+                continue;
+            }
+
+            const int i = top.Cursor++;
+            const int v = graph.Neighbors[i];
+            path.Relax(!m_Visited.Contains(v));
+
+            if (m_Visited.Contains(v)) {
+                continue;
+            }
+
+            if (v == end) {
+                for (size_t frame = m_Frames.size(); frame-- > 0; ) {
+                    const int edge_index = graph.EdgeIndices[m_Frames[frame].Cursor - 1];
+                    path.Record(edge_index);
+                    s.push_back(edge_index);
+                }
+                return;
+            }
+
+            m_Visited.Insert(v);
+            path.Record(graph.EdgeIndices[i]);
+            s.push_back(graph.EdgeIndices[i]);
+            m_Frames.push_back({ v, graph.Offsets[v] });
+            path.Push(m_Frames.size());
+            path.Settle();
+        }
+    }
+
+    // Kept between queries, the visited set resets in O(1) and the frame stack is reserved for the deepest possible
+    // search up front
+    EpochMarks m_Visited;
+    std::vector<Frame> m_Frames;
+
     TraversalResult m_Result;
 };
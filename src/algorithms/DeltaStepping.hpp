@@ -0,0 +1,358 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../parallel.hpp"
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+
+// Delta-stepping (Meyer & Sanders): vertices are kept in buckets of width delta instead of a priority queue, and all the
+// vertices of the lowest bucket are relaxed together, split across threads. Light arcs (weight <= delta) can put a vertex
+// back into the bucket being processed, so they are relaxed until the bucket stays empty, heavy arcs can only reach later
+// buckets and are relaxed once per settled vertex afterwards. Every thread collects the vertices it improved in its own
+// bucket lists, and the tentative distances are updated with a compare and swap so no locks are taken during a phase.
+class DeltaStepping : public Algorithm {
+public:
+    // delta <= 0 picks the mean arc weight of the graph, thread_count 0 uses every core
+    explicit DeltaStepping(float delta = 0.0f, unsigned thread_count = 0)
+        : m_Delta(delta), m_ThreadCount(thread_count) {}
+
+    inline AlgorithmType GetName() const override { return AlgorithmType::DeltaStepping; }
+
+    // Picks the bucket width and reorders every vertex's arcs so the light ones come first
+    void Preprocess(const CSRGraph& graph) override {
+        const int n = graph.GetVertexCount();
+        const int arc_count = graph.GetArcCount();
+
+        m_GraphId = graph.Id;
+
+        double total_weight = 0.0;
+        for (int i = 0; i < arc_count; ++i) {
+            total_weight += graph.Weights[i];
+        }
+
+        m_BucketWidth = m_Delta > 0.0f ? m_Delta : (arc_count > 0 ? (float)(total_weight / arc_count) : 1.0f);
+
+        m_Arcs.resize(arc_count);
+        m_LightEnd.resize(n);
+
+        for (int u = 0; u < n; ++u) {
+            int light = graph.Offsets[u];
+            int heavy = graph.Offsets[u + 1];
+
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                const Arc arc = { graph.Neighbors[i], graph.Weights[i], graph.EdgeIndices[i] };
+                if (arc.Weight <= m_BucketWidth) {
+                    m_Arcs[light++] = arc;
+                }
+                else {
+                    m_Arcs[--heavy] = arc;
+                }
+            }
+
+            m_LightEnd[u] = light;
+        }
+    }
+
+    bool HasPreprocessing() const override { return true; }
+
+    bool IsPreprocessedFor(const CSRGraph& graph) const override { return m_GraphId == graph.Id; }
+
+    size_t GetPreprocessedBytes() const override {
+        return m_Arcs.size() * sizeof(Arc) + m_LightEnd.size() * sizeof(int);
+    }
+
+    bool IsMultithreaded() const override { return true; }
+
+    void SetThreadCount(unsigned thread_count) override {
+        m_ThreadCount = thread_count;
+    }
+
+    unsigned GetThreadCount() const override {
+        return m_ThreadCount == 0 ? GetDefaultThreadCount() : m_ThreadCount;
+    }
+
+    inline float GetBucketWidth() const { return m_BucketWidth; }
+
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    // The log is written on the calling thread only, so the playback order is the same on every run
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    struct Arc {
+        int Target;
+        float Weight;
+        int Edge;
+    };
+
+    // Buckets and settled vertices of one thread, padded so two threads never write to the same cache line
+    struct alignas(64) Worker {
+        std::vector<std::vector<int>> Buckets;
+        std::vector<int> Settled;
+    };
+
+    // Vertices handed out to a thread at a time, and the frontier size below which waking the other threads costs more
+    // than relaxing the frontier on the calling thread
+    static constexpr size_t ChunkSize = 64;
+    static constexpr size_t ParallelThreshold = 256;
+
+    // A tentative distance and the arc it was reached over share one 64 bit word, so a compare and swap updates both
+    // together. Non-negative floats order the same as their bit patterns, which keeps the distance comparable as an integer.
+    static constexpr uint32_t NoArc = std::numeric_limits<uint32_t>::max();
+
+    static inline uint64_t Pack(float distance, uint32_t arc) {
+        uint32_t bits;
+        std::memcpy(&bits, &distance, sizeof(bits));
+        return ((uint64_t)bits << 32) | arc;
+    }
+
+    static inline uint32_t DistanceBits(uint64_t packed) { return (uint32_t)(packed >> 32); }
+    static inline uint32_t ArcOf(uint64_t packed) { return (uint32_t)packed; }
+
+    static inline float DistanceOf(uint64_t packed) {
+        const uint32_t bits = DistanceBits(packed);
+        float distance;
+        std::memcpy(&distance, &bits, sizeof(distance));
+        return distance;
+    }
+
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        const int n = graph.GetVertexCount();
+
+        // The light/heavy split holds the arcs of the graph it was built for
+        if (!IsPreprocessedFor(graph)) {
+            m_Result.Clear();
+            return;
+        }
+
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
+
+        const unsigned thread_count = Recorder::Enabled ? 1 : GetThreadCount();
+        if (thread_count > 1 && (!m_Team || m_Team->GetThreadCount() != thread_count)) {
+            m_Team = std::make_unique<ThreadTeam>(thread_count);
+        }
+
+        if (m_Capacity < n) {
+            m_Tentative = std::make_unique<std::atomic<uint64_t>[]>(n);
+            m_Relaxed = std::make_unique<std::atomic<uint32_t>[]>(n);
+            m_Capacity = n;
+        }
+
+        m_Workers.resize(std::max<size_t>(m_Workers.size(), thread_count));
+        for (Worker& worker : m_Workers) {
+            for (auto& bucket : worker.Buckets) {
+                bucket.clear();
+            }
+            worker.Settled.clear();
+        }
+
+        // Runs fn(thread_index) on every thread, or only on the caller when the work is too small to split
+        auto run = [&](size_t work, auto&& fn) {
+            if (thread_count == 1 || work < ParallelThreshold) {
+                fn(0u);
+            }
+            else {
+                m_Team->Run(fn);
+            }
+        };
+
+        const uint64_t unreached = Pack(std::numeric_limits<float>::infinity(), NoArc);
+        run((size_t)n, [&](unsigned thread) {
+            const int parts = (int)((size_t)n < ParallelThreshold ? 1 : thread_count);
+            const int first = (int)((int64_t)n * thread / parts);
+            const int last = (int)((int64_t)n * (thread + 1) / parts);
+            for (int v = first; v < last; ++v) {
+                m_Tentative[v].store(unreached, std::memory_order_relaxed);
+                m_Relaxed[v].store(DistanceBits(unreached), std::memory_order_relaxed);
+            }
+        });
+
+        // Entries across every bucket, only counted for the recorded run, which stays on one thread
+        size_t queued = 0;
+
+        const float width = m_BucketWidth;
+        auto bucket_of = [width](float distance) { return (size_t)(distance / width); };
+
+        auto relax = [&](Worker& worker, int arc_index, float distance) {
+            const Arc& arc = m_Arcs[arc_index];
+            const uint64_t next = Pack(distance + arc.Weight, (uint32_t)arc_index);
+
+            uint64_t current = m_Tentative[arc.Target].load(std::memory_order_relaxed);
+            while (DistanceBits(next) < DistanceBits(current)) {
+                if (m_Tentative[arc.Target].compare_exchange_weak(current, next, std::memory_order_relaxed)) {
+                    const size_t bucket = bucket_of(DistanceOf(next));
+                    if (bucket >= worker.Buckets.size()) {
+                        worker.Buckets.resize(bucket + 1);
+                    }
+
+                    worker.Buckets[bucket].push_back(arc.Target);
+                    recorder.Relax(true);
+                    if constexpr (Recorder::Enabled) {
+                        recorder.Push(++queued, DistanceBits(current) != DistanceBits(unreached));
+                    }
+                    recorder.Record(arc.Edge);
+                    return;
+                }
+            }
+
+            recorder.Relax(false);
+        };
+
+        // Relaxes the arcs in [first(u), last(u)) of every vertex in m_Frontier, chunks are handed out dynamically
+        auto relax_frontier = [&](bool light) {
+            std::atomic<size_t> cursor{ 0 };
+            const size_t size = m_Frontier.size();
+
+            run(size, [&](unsigned thread) {
+                Worker& worker = m_Workers[thread];
+
+                for (size_t begin = cursor.fetch_add(ChunkSize); begin < size; begin = cursor.fetch_add(ChunkSize)) {
+                    const size_t chunk_end = std::min(begin + ChunkSize, size);
+
+                    for (size_t index = begin; index < chunk_end; ++index) {
+                        const int u = m_Frontier[index];
+                        const uint64_t packed = m_Tentative[u].load(std::memory_order_relaxed);
+                        const float distance = DistanceOf(packed);
+
+                        if (light) {
+                            if constexpr (Recorder::Enabled) {
+                                queued--;
+                            }
+                            recorder.Pop();
+
+                            // Skip entries left behind by an improvement into a lower bucket, and duplicates whose
+                            // distance was already relaxed
+                            if (bucket_of(distance) != m_CurrentBucket) { continue; }
+                            if (m_Relaxed[u].exchange(DistanceBits(packed), std::memory_order_relaxed) == DistanceBits(packed)) { continue; }
+
+                            worker.Settled.push_back(u);
+                            recorder.Settle();
+                            for (int i = graph.Offsets[u]; i < m_LightEnd[u]; ++i) {
+                                relax(worker, i, distance);
+                            }
+                        }
+                        else {
+                            for (int i = m_LightEnd[u]; i < graph.Offsets[u + 1]; ++i) {
+                                relax(worker, i, distance);
+                            }
+                        }
+                    }
+                }
+            });
+        };
+
+        m_Tentative[start].store(Pack(0.0f, NoArc), std::memory_order_relaxed);
+        m_Workers[0].Buckets.resize(std::max<size_t>(m_Workers[0].Buckets.size(), 1));
+        m_Workers[0].Buckets[0].push_back(start);
+        if constexpr (Recorder::Enabled) {
+            recorder.Push(++queued);
+        }
+
+        // Moves every thread's entries of the current bucket into the shared frontier
+        auto gather_bucket = [&]() {
+            m_Frontier.clear();
+            for (unsigned thread = 0; thread < thread_count; ++thread) {
+                auto& buckets = m_Workers[thread].Buckets;
+                if (m_CurrentBucket < buckets.size()) {
+                    m_Frontier.insert(m_Frontier.end(), buckets[m_CurrentBucket].begin(), buckets[m_CurrentBucket].end());
+                    buckets[m_CurrentBucket].clear();
+                }
+            }
+            return !m_Frontier.empty();
+        };
+
+        m_CurrentBucket = 0;
+        while (true) {
+            size_t bucket_count = 0;
+            for (unsigned thread = 0; thread < thread_count; ++thread) {
+                bucket_count = std::max(bucket_count, m_Workers[thread].Buckets.size());
+            }
+
+            auto bucket_empty = [&](size_t bucket) {
+                for (unsigned thread = 0; thread < thread_count; ++thread) {
+                    const auto& buckets = m_Workers[thread].Buckets;
+                    if (bucket < buckets.size() && !buckets[bucket].empty()) { return false; }
+                }
+                return true;
+            };
+
+            while (m_CurrentBucket < bucket_count && bucket_empty(m_CurrentBucket)) {
+                m_CurrentBucket++;
+            }
+
+            if (m_CurrentBucket >= bucket_count) { break; }
+
+            // Every vertex in a lower bucket is final, so the end can stop the search once its bucket is done
+            const uint64_t end_packed = m_Tentative[end].load(std::memory_order_relaxed);
+            if (DistanceBits(end_packed) != DistanceBits(unreached) && bucket_of(DistanceOf(end_packed)) < m_CurrentBucket) { break; }
+
+            for (unsigned thread = 0; thread < thread_count; ++thread) {
+                m_Workers[thread].Settled.clear();
+            }
+
+            while (gather_bucket()) {
+                relax_frontier(true);
+            }
+
+            m_Frontier.clear();
+            for (unsigned thread = 0; thread < thread_count; ++thread) {
+                const auto& settled = m_Workers[thread].Settled;
+                m_Frontier.insert(m_Frontier.end(), settled.begin(), settled.end());
+            }
+
+            relax_frontier(false);
+            m_CurrentBucket++;
+        }
+
+        const uint64_t final_packed = m_Tentative[end].load(std::memory_order_relaxed);
+        if (DistanceBits(final_packed) == DistanceBits(unreached)) {
+            m_Result.Clear();
+            return;
+        }
+
+        // Arcs are stored in the range of their source vertex, so the source is found again with a binary search
+        std::vector<int>& edges = m_Result.FinalEdges;
+        for (uint32_t arc = ArcOf(final_packed); arc != NoArc; ) {
+            edges.push_back(m_Arcs[arc].Edge);
+
+            const int u = (int)(std::upper_bound(graph.Offsets.begin(), graph.Offsets.end(), (int)arc) - graph.Offsets.begin()) - 1;
+            arc = ArcOf(m_Tentative[u].load(std::memory_order_relaxed));
+        }
+
+        std::reverse(edges.begin(), edges.end());
+    }
+
+    float m_Delta;
+    unsigned m_ThreadCount;
+
+    uint64_t m_GraphId = 0;
+    float m_BucketWidth = 1.0f;
+    std::vector<Arc> m_Arcs;
+    std::vector<int> m_LightEnd;
+
+    // Kept between queries so the threads and buffers are reused
+    std::unique_ptr<ThreadTeam> m_Team;
+    int m_Capacity = 0;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_Tentative;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_Relaxed;
+    std::vector<Worker> m_Workers;
+    std::vector<int> m_Frontier;
+    size_t m_CurrentBucket = 0;
+
+    TraversalResult m_Result;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../algorithm.hpp"
+#include "../search_workspace.hpp"
 #include <vector>
 #include <limits>
 #include <algorithm>
@@ -10,15 +11,33 @@ public:
 
     inline AlgorithmType GetName() const override { return AlgorithmType::DijkstraArray; }
 
-    void FindPath(const AdjacencyMatrix& graph, int start, int end) override {
-        int n = graph.size();
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
 
-        std::vector<float> dist(n, std::numeric_limits<float>::max());
-        std::vector<bool> visited(n, false);
-        std::vector<int> parent(n, -1);
-        std::vector<int> parent_edge(n, -1);
+        int n = graph.GetVertexCount();
 
-        dist[start] = 0.0f;
+        SearchTree<float>& tree = m_Tree;
+        tree.Reset(n, std::numeric_limits<float>::max());
+
+        EpochMarks& visited = m_Visited;
+        visited.Reset(n);
+
+        tree.Update(start, 0.0f, -1, -1);
 
         for (int i = 0; i < n; i++) {
 
@@ -26,54 +45,44 @@ public:
             float minVal = std::numeric_limits<float>::max();
 
             for (int j = 0; j < n; j++) {
-                if (!visited[j] && dist[j] < minVal) {
-                    minVal = dist[j];
+                if (!visited.Contains(j) && tree.GetDistance(j) < minVal) {
+                    minVal = tree.GetDistance(j);
                     u = j;
                 }
             }
 
-            if (u == -1 || dist[u] == std::numeric_limits<float>::max()) {
+            if (u == -1 || minVal == std::numeric_limits<float>::max()) {
                 break;
             }
 
-            visited[u] = true;
+            visited.Insert(u);
+            recorder.Settle();
 
             if (u == end) {
-                std::vector<int> edges;
-                int node = end;
-
-                while (parent[node] != -1) {
-                    edges.push_back(parent_edge[node]);
-                    node = parent[node];
-                }
-
-                std::reverse(edges.begin(), edges.end());
-                m_Result.FinalEdges = std::move(edges);
+                tree.GetPathTo(end, m_Result.FinalEdges);
                 return;
             }
 
 
-            for (int v = 0; v < n; v++) {
-                const auto [weight, edge_index] = graph[u][v];
-                if (weight > 0.0f && !visited[v]) {
-                    float alt = dist[u] + weight;
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; i++) {
+                const int v = graph.Neighbors[i];
+                if (!visited.Contains(v)) {
+                    const float dist_v = tree.GetDistance(v);
+                    float alt = minVal + graph.Weights[i];
+                    recorder.Relax(alt < dist_v);
 
-                    if (alt < dist[v]) {
-                        dist[v] = alt;
-                        parent[v] = u;
-                        parent_edge[v] = edge_index;
-                        m_Result.TraversedEdges.push_back(edge_index);
+                    if (alt < dist_v) {
+                        tree.Update(v, alt, u, graph.EdgeIndices[i]);
+                        recorder.Record(graph.EdgeIndices[i]);
                     }
                 }
             }
         }
-        m_Result = {};
+        m_Result.Clear();
     }
 
-    TraversalResult GetResult() override {
-        return m_Result;
-    }
+    SearchTree<float> m_Tree;
+    EpochMarks m_Visited;
 
-private:
     TraversalResult m_Result;
 };
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../indexed_heap.hpp"
+#include "../search_workspace.hpp"
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+// Dijkstra on an indexed d-ary heap with decrease-key. Unlike DijkstraQueue's lazy deletion every vertex is in the queue
+// at most once, so the queue never holds more than V entries and no stale entries are ever popped.
+class DijkstraIndexedHeap : public Algorithm {
+public:
+    // Arity of the heap, only the ones IsSupportedArity accepts have a search compiled for them
+    explicit DijkstraIndexedHeap(unsigned arity = 4)
+        : m_Arity(arity) {
+        assert(IsSupportedArity(arity));
+    }
+
+    static bool IsSupportedArity(unsigned arity) { return arity == 2 || arity == 4 || arity == 8; }
+
+    unsigned GetArity() const { return m_Arity; }
+
+    inline AlgorithmType GetName() const override { return AlgorithmType::DijkstraIndexedHeap; }
+
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Dispatch<NullRecorder>(graph, start, end);
+    }
+
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Dispatch<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    template <typename Recorder>
+    void Dispatch(const CSRGraph& graph, int start, int end) {
+        switch (m_Arity) {
+            case 2: Search<Recorder, 2>(graph, start, end); break;
+            case 4: Search<Recorder, 4>(graph, start, end); break;
+            case 8: Search<Recorder, 8>(graph, start, end); break;
+            // Never quietly search with another arity than asked for
+            default: m_Result.Clear(); break;
+        }
+    }
+
+    template <typename Recorder, unsigned Arity>
+    void Search(const CSRGraph& graph, int start, int end) {
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
+
+        int n = graph.GetVertexCount();
+
+        SearchTree<float>& tree = m_Tree;
+        tree.Reset(n, std::numeric_limits<float>::max());
+
+        IndexedDaryHeap<float, Arity>& heap = GetHeap<Arity>();
+        heap.Reset(n);
+
+        tree.Update(start, 0.0f, -1, -1);
+        heap.Push(start, 0.0f);
+        recorder.Push(heap.Size());
+
+        while (!heap.Empty()) {
+            const float d = heap.TopKey();
+            int u = heap.Pop();
+            recorder.Pop();
+            recorder.Settle();
+
+            if (u == end) {
+                tree.GetPathTo(end, m_Result.FinalEdges);
+                return;
+            }
+
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                const int v = graph.Neighbors[i];
+                const int edge_index = graph.EdgeIndices[i];
+                const float dist_v = tree.GetDistance(v);
+                float alt = d + graph.Weights[i];
+                recorder.Relax(alt < dist_v);
+
+                if (alt < dist_v) {
+                    tree.Update(v, alt, u, edge_index);
+
+                    // Weights are positive so a settled vertex never gets here again, only queued or unseen ones do
+                    if (heap.PushOrDecrease(v, alt)) {
+                        recorder.Push(heap.Size());
+                    }
+
+                    recorder.Record(edge_index);
+                }
+            }
+        }
+
+        m_Result.Clear();
+    }
+
+    template <unsigned Arity>
+    IndexedDaryHeap<float, Arity>& GetHeap() {
+        if constexpr (Arity == 2) { return m_Heap2; }
+        else if constexpr (Arity == 8) { return m_Heap8; }
+        else { return m_Heap4; }
+    }
+
+    unsigned m_Arity;
+
+    // Kept between queries, only the heap of the arity in use ever grows
+    SearchTree<float> m_Tree;
+    IndexedDaryHeap<float, 2> m_Heap2;
+    IndexedDaryHeap<float, 4> m_Heap4;
+    IndexedDaryHeap<float, 8> m_Heap8;
+
+    TraversalResult m_Result;
+};
@@ -1,76 +1,86 @@
 #pragma once
 
 #include "../algorithm.hpp"
+#include "../search_workspace.hpp"
 #include <limits>
 #include <vector>
-#include <queue>
-#include <algorithm>
-#include <functional>
+#include <utility>
 
 class DijkstraQueue : public Algorithm {
 public:
     inline AlgorithmType GetName() const override { return AlgorithmType::DijkstraQueue; }
 
-    void FindPath(const AdjacencyMatrix &graph, int start, int end) override {
-        int n = graph.size();
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
 
-        std::vector<float> dist(n, std::numeric_limits<float>::max());
-        std::vector<int> parent(n, -1);
-        std::vector<int> parent_edge(n, -1);
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
 
-        using Element = std::pair<float, int>;
-        std::priority_queue<Element, std::vector<Element>, std::greater<Element>> pq;
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
 
-        dist[start] = 0.0f;
-        pq.push({0.0f, start});
+private:
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
 
-        while (!pq.empty()) {
-            float d = pq.top().first;
-            int u = pq.top().second;
-            pq.pop();
+        int n = graph.GetVertexCount();
 
-            if (d > dist[u]) { continue; }
+        SearchTree<float>& tree = m_Tree;
+        tree.Reset(n, std::numeric_limits<float>::max());
 
-            if (u == end) {
-                std::vector<int> edges;
-                int node = end;
+        MinQueue<Element>& pq = m_Queue;
+        pq.Clear();
 
-                while (parent[node] != -1) {
-                    edges.push_back(parent_edge[node]);
-                    node = parent[node];
-                }
+        tree.Update(start, 0.0f, -1, -1);
+        pq.Push({0.0f, start});
+        recorder.Push(pq.Size());
+
+        while (!pq.Empty()) {
+            float d = pq.Top().first;
+            int u = pq.Top().second;
+            pq.Pop();
+            recorder.Pop();
 
-                std::reverse(edges.begin(), edges.end());
-                m_Result.FinalEdges = std::move(edges);
+            if (d > tree.GetDistance(u)) { continue; }
+            recorder.Settle();
+
+            if (u == end) {
+                tree.GetPathTo(end, m_Result.FinalEdges);
                 return;
             }
 
-            for (int v = 0; v < n; ++v) {
-                const auto [weight, edge_index] = graph[u][v];
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                const int v = graph.Neighbors[i];
+                const int edge_index = graph.EdgeIndices[i];
+                const float dist_v = tree.GetDistance(v);
+                float alt = d + graph.Weights[i];
+                recorder.Relax(alt < dist_v);
 
-                if (weight > 0.0f) {
-                    float alt = dist[u] + weight;
+                if (alt < dist_v) {
+                    // A vertex that already has a distance is still in the queue, that entry goes stale
+                    const bool reinsertion = dist_v != std::numeric_limits<float>::max();
+                    tree.Update(v, alt, u, edge_index);
 
-                    if (alt < dist[v]) {
-                        dist[v] = alt;
-                        parent[v] = u;
-                        parent_edge[v] = edge_index;
+                    pq.Push({alt, v});
+                    recorder.Push(pq.Size(), reinsertion);
 
-                        pq.push({alt, v});
-
-                        m_Result.TraversedEdges.push_back(edge_index);
-                    }
+                    recorder.Record(edge_index);
                 }
             }
         }
 
-        m_Result = {};
+        m_Result.Clear();
     }
 
-    TraversalResult GetResult() override {
-        return m_Result;
-    }
+    using Element = std::pair<float, int>;
+
+    SearchTree<float> m_Tree;
+    MinQueue<Element> m_Queue;
 
-private:
     TraversalResult m_Result;
 };
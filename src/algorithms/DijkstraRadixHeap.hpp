@@ -0,0 +1,125 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../radix_heap.hpp"
+#include "../search_workspace.hpp"
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Dijkstra on a monotone radix heap. The edge weights are quantized to integer multiples of the resolution (at least one
+// step, so no edge becomes free), which gives amortized O(1) queue operations but can pick a path that is only shortest
+// under the rounded weights. The quantized length of the path is reported as SearchDistance so the error can be shown.
+class DijkstraRadixHeap : public Algorithm {
+public:
+    static constexpr float DefaultResolution = 0.01f;
+
+    // Graph units per integer weight step
+    explicit DijkstraRadixHeap(float resolution = DefaultResolution)
+        : m_Resolution(resolution > 0.0f ? resolution : DefaultResolution) {}
+
+    inline AlgorithmType GetName() const override { return AlgorithmType::DijkstraRadixHeap; }
+
+    void Preprocess(const CSRGraph& graph) override {
+        m_GraphId = graph.Id;
+        m_QuantizedWeights.resize(graph.GetArcCount());
+
+        const double max_weight = (double)std::numeric_limits<uint32_t>::max();
+        for (int i = 0; i < graph.GetArcCount(); ++i) {
+            const double steps = std::round((double)graph.Weights[i] / m_Resolution);
+            m_QuantizedWeights[i] = (uint32_t)std::clamp(steps, 1.0, max_weight);
+        }
+    }
+
+    bool HasPreprocessing() const override { return true; }
+
+    bool IsPreprocessedFor(const CSRGraph& graph) const override { return m_GraphId == graph.Id; }
+
+    size_t GetPreprocessedBytes() const override {
+        return m_QuantizedWeights.size() * sizeof(uint32_t);
+    }
+
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        // Quantized weights of another graph would search the wrong distances
+        if (!IsPreprocessedFor(graph)) {
+            m_Result.Clear();
+            return;
+        }
+
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
+
+        int n = graph.GetVertexCount();
+
+        SearchTree<uint64_t>& tree = m_Tree;
+        tree.Reset(n, std::numeric_limits<uint64_t>::max());
+
+        RadixHeap<int>& heap = m_Heap;
+        heap.Clear();
+
+        tree.Update(start, 0, -1, -1);
+        heap.Push(0, start);
+        recorder.Push(heap.Size());
+
+        while (!heap.Empty()) {
+            const auto [d, u] = heap.Pop();
+            recorder.Pop();
+
+            if (d > tree.GetDistance(u)) { continue; }
+            recorder.Settle();
+
+            if (u == end) {
+                tree.GetPathTo(end, m_Result.FinalEdges);
+                m_Result.SearchDistance = (float)((double)d * m_Resolution);
+                return;
+            }
+
+            for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                const int v = graph.Neighbors[i];
+                const int edge_index = graph.EdgeIndices[i];
+                const uint64_t dist_v = tree.GetDistance(v);
+                uint64_t alt = d + m_QuantizedWeights[i];
+                recorder.Relax(alt < dist_v);
+
+                if (alt < dist_v) {
+                    const bool reinsertion = dist_v != std::numeric_limits<uint64_t>::max();
+                    tree.Update(v, alt, u, edge_index);
+
+                    heap.Push(alt, v);
+                    recorder.Push(heap.Size(), reinsertion);
+
+                    recorder.Record(edge_index);
+                }
+            }
+        }
+
+        m_Result.Clear();
+    }
+
+    float m_Resolution;
+
+    uint64_t m_GraphId = 0;
+    std::vector<uint32_t> m_QuantizedWeights;
+
+    // Kept between queries so the bucket storage is reused, the tree resets in O(1)
+    SearchTree<uint64_t> m_Tree;
+    RadixHeap<int> m_Heap;
+
+    TraversalResult m_Result;
+};
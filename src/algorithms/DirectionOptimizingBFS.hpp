@@ -0,0 +1,302 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Level synchronous BFS that switches direction per level (Beamer et al.). Top-down steps expand the frontier like the
+// plain BFS, bottom-up steps let every unvisited vertex look for any parent in the frontier and stop at the first one,
+// which is far cheaper once the frontier covers a large part of the graph. Frontier and visited sets are bitmaps with one
+// bit per vertex, and both steps are split across threads over ranges of 64 vertex words.
+class DirectionOptimizingBFS : public Algorithm
+{
+public:
+	// thread_count 0 uses every core
+	explicit DirectionOptimizingBFS(unsigned thread_count = 0)
+		: m_ThreadCount(thread_count) {}
+
+	inline AlgorithmType GetName() const override { return AlgorithmType::DirectionOptimizingBFS; }
+
+	bool IsMultithreaded() const override { return true; }
+	void SetThreadCount(unsigned thread_count) override { m_ThreadCount = thread_count; }
+	unsigned GetThreadCount() const override { return m_ThreadCount == 0 ? GetDefaultThreadCount() : m_ThreadCount; }
+
+	void FindPath(const CSRGraph& graph, int start, int end) override
+	{
+		Search<NullRecorder>(graph, start, end);
+	}
+
+	// The log is written on the calling thread only, each level in vertex order, so the playback is the same on every run
+	void RecordPath(const CSRGraph& graph, int start, int end) override
+	{
+		Search<TraversalLogRecorder>(graph, start, end);
+	}
+
+	TraversalResult GetResult() override
+	{
+		return m_Result;
+	}
+
+private:
+	using Word = uint64_t;
+	static constexpr int WordBits = 64;
+
+	// Switch to bottom-up once the frontier's arcs exceed 1/Alpha of the arcs not explored yet, and back to top-down once
+	// the frontier holds fewer than 1/Beta of the vertices (the defaults from the paper)
+	static constexpr size_t Alpha = 14;
+	static constexpr size_t Beta = 24;
+
+	// Words handed out to a thread at a time, and the work below which a step stays on the calling thread
+	static constexpr size_t ChunkWords = 16;
+	static constexpr size_t ParallelThreshold = 4096;
+
+	// Vertices and arcs added to the next frontier by one thread, padded so threads never share a cache line
+	struct alignas(64) Worker
+	{
+		size_t Vertices = 0;
+		size_t Arcs = 0;
+	};
+
+	template <typename Recorder>
+	void Search(const CSRGraph& graph, int start, int end)
+	{
+		Recorder recorder(m_Result);
+		m_Result.FinalEdges.clear();
+
+		const int n = graph.GetVertexCount();
+		const size_t words = ((size_t)n + WordBits - 1) / WordBits;
+
+		const unsigned threadCount = Recorder::Enabled ? 1 : GetThreadCount();
+		if (threadCount > 1 && (!m_Team || m_Team->GetThreadCount() != threadCount))
+			m_Team = std::make_unique<ThreadTeam>(threadCount);
+
+		if (m_Capacity < words)
+		{
+			m_Visited = std::make_unique<std::atomic<Word>[]>(words);
+			m_Frontier = std::make_unique<std::atomic<Word>[]>(words);
+			m_Next = std::make_unique<std::atomic<Word>[]>(words);
+			m_Capacity = words;
+		}
+
+		// Only entries of visited vertices are ever read, so these don't need clearing between queries
+		m_Parent.resize(n);
+		m_ParentEdge.resize(n);
+		m_Workers.resize(threadCount);
+
+		// Runs step(thread_index, first_word, last_word) over all the words, in chunks across threads when there is enough work
+		auto run = [&](size_t work, auto&& step)
+		{
+			if (threadCount == 1 || work < ParallelThreshold)
+			{
+				step(0u, (size_t)0, words);
+				return;
+			}
+
+			std::atomic<size_t> cursor{ 0 };
+			m_Team->Run([&](unsigned thread)
+			{
+				for (size_t first = cursor.fetch_add(ChunkWords); first < words; first = cursor.fetch_add(ChunkWords))
+					step(thread, first, std::min(first + ChunkWords, words));
+			});
+		};
+
+		auto bit = [](int v) { return (Word)1 << (v % WordBits); };
+
+		// The bits past the last vertex are marked visited so bottom-up steps never pick them up
+		run((size_t)n, [&](unsigned, size_t first, size_t last)
+		{
+			for (size_t word = first; word < last; word++)
+			{
+				const size_t firstVertex = word * WordBits;
+				const Word padding = firstVertex + WordBits > (size_t)n ? ~Word(0) << ((size_t)n - firstVertex) : 0;
+				m_Visited[word].store(padding, std::memory_order_relaxed);
+				m_Frontier[word].store(0, std::memory_order_relaxed);
+				m_Next[word].store(0, std::memory_order_relaxed);
+			}
+		});
+
+		m_Visited[start / WordBits].fetch_or(bit(start), std::memory_order_relaxed);
+		m_Frontier[start / WordBits].fetch_or(bit(start), std::memory_order_relaxed);
+		m_Parent[start] = -1;
+		recorder.Push(1);
+
+		size_t frontierVertices = 1;
+		size_t frontierArcs = (size_t)graph.GetDegree(start);
+		size_t unexploredArcs = (size_t)graph.GetArcCount() - frontierArcs;
+		bool bottomUp = false;
+		bool nextDirty = false;
+
+		auto visited = [&](int v) { return (m_Visited[v / WordBits].load(std::memory_order_relaxed) & bit(v)) != 0; };
+
+		while (frontierVertices > 0 && !visited(end))
+		{
+			if (!bottomUp && frontierArcs > unexploredArcs / Alpha)
+				bottomUp = true;
+			else if (bottomUp && frontierVertices < (size_t)n / Beta)
+				bottomUp = false;
+
+			for (Worker& worker : m_Workers)
+				worker = {};
+
+			if (bottomUp)
+			{
+				// Every word of the next frontier is written by the thread that owns it, so no clearing or atomics are needed
+				run((size_t)n, [&](unsigned thread, size_t first, size_t last)
+				{
+					Worker& worker = m_Workers[thread];
+
+					for (size_t word = first; word < last; word++)
+					{
+						Word unvisited = ~m_Visited[word].load(std::memory_order_relaxed);
+						Word found = 0;
+
+						for (; unvisited != 0; unvisited &= unvisited - 1)
+						{
+							const int v = (int)(word * WordBits) + CountTrailingZeros(unvisited);
+							recorder.Settle();
+
+							for (int i = graph.Offsets[v]; i < graph.Offsets[v + 1]; i++)
+							{
+								const int u = graph.Neighbors[i];
+								const bool parent = (m_Frontier[u / WordBits].load(std::memory_order_relaxed) & bit(u)) != 0;
+								recorder.Relax(parent);
+
+								if (!parent)
+									continue;
+
+								m_Parent[v] = u;
+								m_ParentEdge[v] = graph.EdgeIndices[i];
+								found |= bit(v);
+
+								worker.Vertices++;
+								worker.Arcs += graph.GetDegree(v);
+								recorder.Push(worker.Vertices);
+								recorder.Record(graph.EdgeIndices[i]);
+								break;
+							}
+						}
+
+						m_Next[word].store(found, std::memory_order_relaxed);
+						if (found != 0)
+							m_Visited[word].fetch_or(found, std::memory_order_relaxed);
+					}
+				});
+			}
+			else
+			{
+				// A top-down step clears the frontier words as it reads them, so the buffer it becomes next is empty, only
+				// the frontier a bottom-up step wrote needs clearing
+				if (nextDirty)
+				{
+					run(frontierArcs, [&](unsigned, size_t first, size_t last)
+					{
+						for (size_t word = first; word < last; word++)
+							m_Next[word].store(0, std::memory_order_relaxed);
+					});
+				}
+
+				// Vertices are claimed with an atomic or on the visited word, the thread that set the bit owns the vertex
+				run(frontierArcs, [&](unsigned thread, size_t first, size_t last)
+				{
+					Worker& worker = m_Workers[thread];
+
+					for (size_t word = first; word < last; word++)
+					{
+						Word frontier = m_Frontier[word].load(std::memory_order_relaxed);
+						if (frontier == 0)
+							continue;
+
+						m_Frontier[word].store(0, std::memory_order_relaxed);
+						for (; frontier != 0; frontier &= frontier - 1)
+						{
+							const int u = (int)(word * WordBits) + CountTrailingZeros(frontier);
+							recorder.Pop();
+							recorder.Settle();
+
+							for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; i++)
+							{
+								const int v = graph.Neighbors[i];
+								std::atomic<Word>& visitedWord = m_Visited[v / WordBits];
+
+								if ((visitedWord.load(std::memory_order_relaxed) & bit(v)) != 0)
+								{
+									recorder.Relax(false);
+									continue;
+								}
+								if ((visitedWord.fetch_or(bit(v), std::memory_order_relaxed) & bit(v)) != 0)
+								{
+									recorder.Relax(false);
+									continue;
+								}
+
+								m_Parent[v] = u;
+								m_ParentEdge[v] = graph.EdgeIndices[i];
+								m_Next[v / WordBits].fetch_or(bit(v), std::memory_order_relaxed);
+
+								worker.Vertices++;
+								worker.Arcs += graph.GetDegree(v);
+								recorder.Relax(true);
+								recorder.Push(worker.Vertices);
+								recorder.Record(graph.EdgeIndices[i]);
+							}
+						}
+					}
+				});
+			}
+
+			frontierVertices = 0;
+			frontierArcs = 0;
+			for (const Worker& worker : m_Workers)
+			{
+				frontierVertices += worker.Vertices;
+				frontierArcs += worker.Arcs;
+			}
+
+			unexploredArcs -= std::min(unexploredArcs, frontierArcs);
+			std::swap(m_Frontier, m_Next);
+			nextDirty = bottomUp;
+		}
+
+		if (!visited(end))
+		{
+			m_Result.Clear();
+			return;
+		}
+
+		std::vector<int>& edges = m_Result.FinalEdges;
+		for (int node = end; node != start; node = m_Parent[node])
+			edges.push_back(m_ParentEdge[node]);
+
+		std::reverse(edges.begin(), edges.end());
+	}
+
+	static inline int CountTrailingZeros(Word x)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctzll(x);
+#else
+		int count = 0;
+		for (; (x & 1) == 0; x >>= 1)
+			count++;
+		return count;
+#endif
+	}
+
+	unsigned m_ThreadCount;
+
+	// Kept between queries so the threads and buffers are reused
+	std::unique_ptr<ThreadTeam> m_Team;
+	size_t m_Capacity = 0;
+	std::unique_ptr<std::atomic<Word>[]> m_Visited;
+	std::unique_ptr<std::atomic<Word>[]> m_Frontier;
+	std::unique_ptr<std::atomic<Word>[]> m_Next;
+	std::vector<int> m_Parent;
+	std::vector<int> m_ParentEdge;
+	std::vector<Worker> m_Workers;
+
+	TraversalResult m_Result;
+};
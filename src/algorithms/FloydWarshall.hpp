@@ -1,69 +1,129 @@
 #pragma once
 
 #include "../algorithm.hpp"
+#include "../all_pairs.hpp"
+#include "../min_plus.hpp"
+#include "../parallel.hpp"
 #include <vector>
 #include <limits>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <cstdint>
 
+// Blocked Floyd-Warshall on one flat, padded distance matrix. Every round k takes one tile wide band of intermediate
+// vertices: first the diagonal tile is closed on itself, then the other tiles of its row and column against it, then
+// every remaining tile against its row and column tile. Those last tiles don't depend on each other, so they are split
+// across threads and go through the widest min-plus kernel the CPU has.
+// No predecessor matrix is kept, the path is walked from the distances afterwards (WalkShortestPath), which halves the
+// memory of the all-pairs table.
 class FloydWarshall : public Algorithm {
 public:
+    // thread_count 0 uses every core
+    explicit FloydWarshall(unsigned thread_count = 0)
+        : m_ThreadCount(thread_count) {}
+
     inline AlgorithmType GetName() const override { return AlgorithmType::FloydWarshall; }
 
-    void FindPath(const AdjacencyMatrix& graph, int start, int end) override {
-        float inf = std::numeric_limits<float>::max();
-        std::vector<std::vector<float>> dist(graph.size(), std::vector<float>(graph.size(), inf));
-        std::vector<std::vector<int>> prev(graph.size(), std::vector<int>(graph.size(), -1));
-        std::vector<std::vector<int>> look_up(graph.size(), std::vector<int>(graph.size(), -1));
-
-        for (size_t u = 0; u < graph.size(); u++) {
-            dist[u][u] = 0.0f;
-            prev[u][u] = u;
-            for (size_t v = 0; v < graph.size(); v++) {
-                const auto [weight, edge_index] = graph[u][v];
-                if (weight > 0.0f) {
-                    dist[u][v] = weight;
-                    prev[u][v] = v;
-                    look_up[u][v] = edge_index;
-                }
-            }
+    bool IsMultithreaded() const override { return true; }
+
+    void SetThreadCount(unsigned thread_count) override {
+        m_ThreadCount = thread_count;
+    }
+
+    unsigned GetThreadCount() const override {
+        return m_ThreadCount == 0 ? GetDefaultThreadCount() : m_ThreadCount;
+    }
+
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        m_Result.Clear();
+
+        const size_t n = graph.GetVertexCount();
+        const size_t tile = MinPlusTileSize;
+        const size_t tiles = (n + tile - 1) / tile;
+        const size_t stride = tiles * tile;
+
+        const unsigned thread_count = GetThreadCount();
+        if (thread_count > 1 && (!m_Team || m_Team->GetThreadCount() != thread_count)) {
+            m_Team = std::make_unique<ThreadTeam>(thread_count);
         }
 
-        for (size_t k = 0; k < graph.size(); k++) {
-            for (size_t i = 0; i < graph.size(); i++) {
-                if (dist[i][k] == inf) continue;
-                for (size_t j = 0; j < graph.size(); j++) {
-                    if (dist[k][j] == inf) continue;
-                    if (dist[i][j] > dist[i][k] + dist[k][j]) {
-                        dist[i][j] = dist[i][k] + dist[k][j];
-                        prev[i][j] = prev[i][k];
-                    }
+        // Calls fn(index) for every index in [0, count), spread over the team when there is more than one index
+        auto parallel_for = [&](size_t count, auto&& fn) {
+            if (thread_count == 1 || count < 2) {
+                for (size_t index = 0; index < count; index++) {
+                    fn(index);
                 }
+                return;
             }
-        }
 
-        if (dist[start][end] == inf) {
-            m_Result = {};
-            return;
-        }
+            std::atomic<size_t> cursor{ 0 };
+            m_Team->Run([&](unsigned) {
+                for (size_t index = cursor++; index < count; index = cursor++) {
+                    fn(index);
+                }
+            });
+        };
 
-        std::vector<int> edges;
-        int curr = start;
+        // Over-allocated by one cache line so the matrix can start on a 64 byte boundary, the padding rows and columns
+        // stay at infinity and never shorten anything
+        const float inf = std::numeric_limits<float>::infinity();
+        const size_t alignment = 64 / sizeof(float);
+        m_Storage.resize(stride * stride + alignment);
 
-        while (curr != end) {
-            int next = prev[curr][end];
+        float* dist = m_Storage.data();
+        dist += (alignment - ((uintptr_t)dist / sizeof(float)) % alignment) % alignment;
 
-            if (next == -1) {
-                m_Result = {};
-                return;
-            }
+        parallel_for(tiles, [&](size_t row_tile) {
+            for (size_t u = row_tile * tile; u < (row_tile + 1) * tile; u++) {
+                float* row = dist + u * stride;
+                std::fill(row, row + stride, inf);
+
+                if (u >= n) { continue; }
 
-            if (look_up[curr][next] != -1) {
-                edges.push_back(look_up[curr][next]);
+                row[u] = 0.0f;
+                for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; i++) {
+                    const int v = graph.Neighbors[i];
+                    row[v] = std::min(row[v], graph.Weights[i]);
+                }
             }
+        });
+
+        auto at = [&](size_t row_tile, size_t column_tile) { return dist + row_tile * tile * stride + column_tile * tile; };
+        const MinPlusKernel kernel = GetMinPlusKernel();
+
+        for (size_t k = 0; k < tiles; k++) {
+            float* diagonal = at(k, k);
+            MinPlusDependentTile(diagonal, diagonal, diagonal, stride);
+
+            // Index t < tiles is the row tile (k, t), the rest are the column tiles (t, k)
+            parallel_for(2 * tiles, [&](size_t index) {
+                const size_t t = index % tiles;
+                if (t == k) { return; }
+
+                if (index < tiles) {
+                    MinPlusDependentTile(at(k, t), diagonal, at(k, t), stride);
+                }
+                else {
+                    MinPlusDependentTile(at(t, k), at(t, k), diagonal, stride);
+                }
+            });
 
-            curr = next;
+            parallel_for(tiles * tiles, [&](size_t index) {
+                const size_t i = index / tiles;
+                const size_t j = index % tiles;
+                if (i == k || j == k) { return; }
+
+                kernel(at(i, j), at(i, k), at(k, j), stride);
+            });
         }
 
-        m_Result.FinalEdges = std::move(edges);
+        WalkShortestPath(graph, start, end, [&](int u) { return dist[(size_t)u * stride + end]; }, m_Result.FinalEdges);
+    }
+
+    // Floyd-Warshall has no incremental traversal to log, so the visualization run is the same search
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        FindPath(graph, start, end);
     }
 
     TraversalResult GetResult() override {
@@ -71,5 +131,11 @@ public:
     }
 
 private:
+    unsigned m_ThreadCount;
+
+    // Kept between queries so the threads and the matrix are reused
+    std::unique_ptr<ThreadTeam> m_Team;
+    std::vector<float> m_Storage;
+
     TraversalResult m_Result;
 };
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../algorithm.hpp"
+#include "../all_pairs.hpp"
+#include "../indexed_heap.hpp"
+#include "../parallel.hpp"
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+// Johnson's all-pairs shortest paths, for sparse graphs where Floyd-Warshall's O(V^3) is wasted on absent edges.
+// Bellman-Ford from a virtual source joined to every vertex gives potentials h that make every arc weight
+// w(u, v) + h(u) - h(v) non-negative, then one Dijkstra per source on the reweighted arcs fills a row of the table,
+// O(V E log V) in total. The sources are independent, so they are spread across threads.
+// With this project's Euclidean weights h is all zeros after the first Bellman-Ford pass, the pass is kept so the
+// algorithm stays correct for negative arcs too.
+class Johnson : public Algorithm {
+public:
+    // thread_count 0 uses every core
+    explicit Johnson(unsigned thread_count = 0)
+        : m_ThreadCount(thread_count) {}
+
+    inline AlgorithmType GetName() const override { return AlgorithmType::Johnson; }
+
+    bool IsMultithreaded() const override { return true; }
+
+    void SetThreadCount(unsigned thread_count) override {
+        m_ThreadCount = thread_count;
+    }
+
+    unsigned GetThreadCount() const override {
+        return m_ThreadCount == 0 ? GetDefaultThreadCount() : m_ThreadCount;
+    }
+
+    void FindPath(const CSRGraph& graph, int start, int end) override {
+        Search<NullRecorder>(graph, start, end);
+    }
+
+    // Only the counters are recorded, a log of every source's search would be V times the size of the graph. The run
+    // stays on one thread so they are collected without synchronization.
+    void RecordPath(const CSRGraph& graph, int start, int end) override {
+        Search<TraversalLogRecorder>(graph, start, end);
+    }
+
+    TraversalResult GetResult() override {
+        return m_Result;
+    }
+
+private:
+    template <typename Recorder>
+    void Search(const CSRGraph& graph, int start, int end) {
+        Recorder recorder(m_Result);
+        m_Result.FinalEdges.clear();
+
+        const int n = graph.GetVertexCount();
+        const float inf = std::numeric_limits<float>::infinity();
+
+        if (!ComputePotentials(graph)) {
+            m_Result.Clear();
+            return;
+        }
+
+        const unsigned thread_count = Recorder::Enabled ? 1 : GetThreadCount();
+        if (thread_count > 1 && (!m_Team || m_Team->GetThreadCount() != thread_count)) {
+            m_Team = std::make_unique<ThreadTeam>(thread_count);
+        }
+
+        m_Heaps.resize(std::max<size_t>(m_Heaps.size(), thread_count));
+        m_Table.resize((size_t)n * n);
+
+        std::atomic<int> next_source{ 0 };
+        auto worker = [&](unsigned thread) {
+            IndexedDaryHeap<float>& heap = m_Heaps[thread];
+
+            for (int source = next_source++; source < n; source = next_source++) {
+                float* dist = m_Table.data() + (size_t)source * n;
+                std::fill(dist, dist + n, inf);
+
+                heap.Reset(n);
+                dist[source] = 0.0f;
+                heap.Push(source, 0.0f);
+                recorder.Push(heap.Size());
+
+                while (!heap.Empty()) {
+                    const int u = heap.Pop();
+                    recorder.Pop();
+                    recorder.Settle();
+
+                    for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                        const int v = graph.Neighbors[i];
+                        const float alt = dist[u] + m_Weights[i];
+                        recorder.Relax(alt < dist[v]);
+
+                        if (alt < dist[v]) {
+                            dist[v] = alt;
+                            if (heap.PushOrDecrease(v, alt)) {
+                                recorder.Push(heap.Size());
+                            }
+                        }
+                    }
+                }
+
+                // Undo the reweighting, d(s, v) = d'(s, v) - h(s) + h(v)
+                for (int v = 0; v < n; ++v) {
+                    if (dist[v] != inf) {
+                        dist[v] += m_Potentials[v] - m_Potentials[source];
+                    }
+                }
+            }
+        };
+
+        if (thread_count == 1) {
+            worker(0);
+        }
+        else {
+            m_Team->Run(worker);
+        }
+
+        // The graph is undirected, so row end holds d(end, v) = d(v, end) contiguously
+        const float* to_end = m_Table.data() + (size_t)end * n;
+
+        WalkShortestPath(graph, start, end, [&](int u) { return to_end[u]; }, m_Result.FinalEdges);
+    }
+
+    // Bellman-Ford from a virtual source with a zero weight arc to every vertex, so every potential starts at 0, then the
+    // reweighted arcs w(u, v) + h(u) - h(v) for the Dijkstra runs. Returns false on a negative cycle.
+    bool ComputePotentials(const CSRGraph& graph) {
+        const int n = graph.GetVertexCount();
+        m_Potentials.assign(n, 0.0f);
+
+        for (int pass = 0; pass <= n; ++pass) {
+            bool changed = false;
+
+            for (int u = 0; u < n; ++u) {
+                for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                    const int v = graph.Neighbors[i];
+                    if (m_Potentials[u] + graph.Weights[i] < m_Potentials[v]) {
+                        m_Potentials[v] = m_Potentials[u] + graph.Weights[i];
+                        changed = true;
+                    }
+                }
+            }
+
+            if (!changed) {
+                m_Weights.resize(graph.GetArcCount());
+                for (int u = 0; u < n; ++u) {
+                    for (int i = graph.Offsets[u]; i < graph.Offsets[u + 1]; ++i) {
+                        m_Weights[i] = graph.Weights[i] + m_Potentials[u] - m_Potentials[graph.Neighbors[i]];
+                    }
+                }
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    unsigned m_ThreadCount;
+
+    std::vector<float> m_Potentials;
+    std::vector<float> m_Weights;
+
+    // Kept between queries so the threads, heaps and table are reused
+    std::unique_ptr<ThreadTeam> m_Team;
+    std::vector<IndexedDaryHeap<float>> m_Heaps;
+    std::vector<float> m_Table;
+
+    TraversalResult m_Result;
+};
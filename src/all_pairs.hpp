@@ -0,0 +1,52 @@
+#pragma once
+
+#include "csr_graph.hpp"
+#include <vector>
+#include <limits>
+
+// Recovers one shortest start-end path from an all-pairs distance table without a predecessor table: every step takes
+// the arc of the current vertex with the smallest w(u, v) + d(v, end), which continues a shortest path.
+// distance_to_end(v) must return d(v, end). Returns false if end is unreachable or the table is inconsistent with the
+// graph. A step may leave the remaining distance unchanged, since w + d(v, end) rounds to d(u, end) when w is below half
+// an ulp of it (near-coincident vertices far from end), so the walk is bounded by the V - 1 arcs of a simple path
+// instead, and ties go to the arc closer to end so rounding doesn't send it back and forth.
+template <typename DistanceFn>
+bool WalkShortestPath(const CSRGraph& graph, int start, int end, DistanceFn&& distance_to_end, std::vector<int>& edges)
+{
+	const float infinity = std::numeric_limits<float>::infinity();
+
+	edges.clear();
+	if (!(distance_to_end(start) < infinity))
+		return false;
+
+	const int maxSteps = graph.GetVertexCount() - 1;
+	for (int curr = start, steps = 0; curr != end; steps++)
+	{
+		int bestArc = -1;
+		float bestTotal = infinity;
+		float bestRemaining = infinity;
+
+		for (int i = graph.Offsets[curr]; i < graph.Offsets[curr + 1]; i++)
+		{
+			const float remaining = distance_to_end(graph.Neighbors[i]);
+			const float total = graph.Weights[i] + remaining;
+			if (total < bestTotal || (total == bestTotal && remaining < bestRemaining))
+			{
+				bestTotal = total;
+				bestRemaining = remaining;
+				bestArc = i;
+			}
+		}
+
+		if (bestArc == -1 || steps == maxSteps)
+		{
+			edges.clear();
+			return false;
+		}
+
+		edges.push_back(graph.EdgeIndices[bestArc]);
+		curr = graph.Neighbors[bestArc];
+	}
+
+	return true;
+}
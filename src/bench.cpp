@@ -0,0 +1,581 @@
+// Headless benchmark runner: times the pathfinding algorithms on a .algograph file without any window or GL context.
+
+#include "graph_file.hpp"
+#include "algorithm_registry.hpp"
+#include "timing_statistics.hpp"
+#include "hardware_counters.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+enum class OutputFormat
+{
+    Json,
+    Csv,
+};
+
+struct BenchOptions
+{
+    std::string GraphPath;
+    std::vector<AlgorithmType> Algorithms;
+    int Source = -1;
+    int Target = -1;
+    uint32_t Pairs = 10;
+    uint32_t Seed = 1;
+    uint32_t Repetitions = 5;
+    uint32_t Warmup = 1;
+    std::vector<unsigned> ThreadCounts; // Empty runs the multithreaded algorithms at their default
+    float Delta = 0.0f;
+    float Resolution = DijkstraRadixHeap::DefaultResolution;
+    uint32_t Arity = 4;
+    bool HardwareCounters = false;
+    OutputFormat Format = OutputFormat::Json;
+};
+
+struct BenchResult
+{
+    AlgorithmType Type;
+    unsigned Threads = 1;
+    TimingStatistics Timing;
+    unsigned Arity = 0; // Heap arity of DijkstraIndexedHeap, 0 for the other algorithms
+    double Speedup = 0.0; // DijkstraQueue median over this median, 0 when DijkstraQueue wasn't run
+    size_t PathsFound = 0;
+    double PreprocessingNs = 0.0;
+    size_t PreprocessedBytes = 0;
+    OperationCounters Counters; // Summed over the pairs, except the peak queue size which is the largest one
+    HardwareCounters Hardware; // Per measured run, averaged over the pairs
+    double PathLength = 0.0; // Float length of the found paths, summed over the pairs
+    double SearchDistance = -1.0; // Summed the same way, negative unless the algorithm searched on approximated weights
+};
+
+static void PrintUsage()
+{
+    std::cerr <<
+        "Usage: gv-bench <graph.algograph> [options]\n"
+        "  --algorithms <list>    Comma separated algorithm identifiers, or \"all\" (default: all)\n"
+        "  --source <vertex>      Source vertex index (requires --target)\n"
+        "  --target <vertex>      Target vertex index (requires --source)\n"
+        "  --pairs <count>        Number of random source/target pairs when no source/target is given (default: 10)\n"
+        "  --seed <value>         Seed for the random pairs (default: 1)\n"
+        "  --repetitions <count>  Measured runs per pair (default: 5)\n"
+        "  --warmup <count>       Unmeasured warm-up runs per pair (default: 1)\n"
+        "  --threads <list>       Comma separated thread counts for the multithreaded algorithms, or \"sweep\" for\n"
+        "                         1,2,4,8 and every core, each count gets its own result (default: every core)\n"
+        "  --delta <width>        Bucket width for DeltaStepping, 0 picks the mean edge weight (default: 0)\n"
+        "  --resolution <step>    Weight quantization step for DijkstraRadixHeap (default: 0.01)\n"
+        "  --arity <2|4|8>        Heap arity for DijkstraIndexedHeap (default: 4)\n"
+        "  --hardware-counters <on|off>\n"
+        "                         Count CPU events of the measured runs with Linux perf_event (default: off)\n"
+        "  --format <json|csv>    Output format (default: json)\n"
+        "Algorithms:";
+
+    for (size_t index = 0; index < AlgorithmTypeCount; index++)
+        std::cerr << " " << AlgorithmTypeToIdentifier((AlgorithmType)index);
+    std::cerr << std::endl;
+}
+
+static bool ParseUnsigned(const char* text, uint32_t& value)
+{
+    char* end = nullptr;
+    const unsigned long parsed = std::strtoul(text, &end, 10);
+    if (end == text || *end != '\0')
+        return false;
+
+    value = (uint32_t)parsed;
+    return true;
+}
+
+static bool ParseFloat(const char* text, float& value)
+{
+    char* end = nullptr;
+    const float parsed = std::strtof(text, &end);
+    if (end == text || *end != '\0')
+        return false;
+
+    value = parsed;
+    return true;
+}
+
+static bool ParseThreadCounts(const std::string& list, std::vector<unsigned>& counts)
+{
+    counts.clear();
+
+    if (list == "sweep")
+    {
+        counts = { 1, 2, 4, 8, GetDefaultThreadCount() };
+        std::sort(counts.begin(), counts.end());
+        counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+        return true;
+    }
+
+    std::stringstream stream(list);
+    std::string count;
+    while (std::getline(stream, count, ','))
+    {
+        uint32_t value = 0;
+        if (!ParseUnsigned(count.c_str(), value) || value == 0)
+        {
+            std::cerr << "Invalid thread count: " << count << std::endl;
+            return false;
+        }
+
+        counts.push_back(value);
+    }
+
+    return !counts.empty();
+}
+
+static bool ParseAlgorithms(const std::string& list, std::vector<AlgorithmType>& algorithms)
+{
+    algorithms.clear();
+
+    if (list == "all")
+    {
+        for (size_t index = 0; index < AlgorithmTypeCount; index++)
+            algorithms.push_back((AlgorithmType)index);
+        return true;
+    }
+
+    std::stringstream stream(list);
+    std::string identifier;
+    while (std::getline(stream, identifier, ','))
+    {
+        AlgorithmType type;
+        if (!AlgorithmTypeFromIdentifier(identifier, type))
+        {
+            std::cerr << "Unknown algorithm: " << identifier << std::endl;
+            return false;
+        }
+
+        algorithms.push_back(type);
+    }
+
+    return !algorithms.empty();
+}
+
+static bool ParseArguments(int argc, char** argv, BenchOptions& options)
+{
+    if (argc < 2)
+        return false;
+
+    options.GraphPath = argv[1];
+    ParseAlgorithms("all", options.Algorithms);
+
+    for (int index = 2; index < argc; index++)
+    {
+        const std::string argument = argv[index];
+        if (index + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << argument << std::endl;
+            return false;
+        }
+
+        const char* value = argv[++index];
+        uint32_t number = 0;
+        float real = 0.0f;
+
+        if (argument == "--algorithms")
+        {
+            if (!ParseAlgorithms(value, options.Algorithms))
+                return false;
+        }
+        else if (argument == "--source" && ParseUnsigned(value, number))
+            options.Source = (int)number;
+        else if (argument == "--target" && ParseUnsigned(value, number))
+            options.Target = (int)number;
+        else if (argument == "--pairs" && ParseUnsigned(value, number))
+            options.Pairs = number;
+        else if (argument == "--seed" && ParseUnsigned(value, number))
+            options.Seed = number;
+        else if (argument == "--repetitions" && ParseUnsigned(value, number) && number > 0)
+            options.Repetitions = number;
+        else if (argument == "--warmup" && ParseUnsigned(value, number))
+            options.Warmup = number;
+        else if (argument == "--threads")
+        {
+            if (!ParseThreadCounts(value, options.ThreadCounts))
+                return false;
+        }
+        else if (argument == "--delta" && ParseFloat(value, real) && real >= 0.0f)
+            options.Delta = real;
+        else if (argument == "--resolution" && ParseFloat(value, real) && real > 0.0f)
+            options.Resolution = real;
+        else if (argument == "--arity" && ParseUnsigned(value, number) && DijkstraIndexedHeap::IsSupportedArity(number))
+            options.Arity = number;
+        else if (argument == "--hardware-counters" && (strcmp(value, "on") == 0 || strcmp(value, "off") == 0))
+            options.HardwareCounters = strcmp(value, "on") == 0;
+        else if (argument == "--format" && (strcmp(value, "json") == 0 || strcmp(value, "csv") == 0))
+            options.Format = strcmp(value, "json") == 0 ? OutputFormat::Json : OutputFormat::Csv;
+        else
+        {
+            std::cerr << "Invalid argument: " << argument << " " << value << std::endl;
+            return false;
+        }
+    }
+
+    if ((options.Source < 0) != (options.Target < 0))
+    {
+        std::cerr << "--source and --target must be given together" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Matches Distance() in the visualizer so both report identical weights
+static float EdgeLength(const GraphFile& graph, const GraphFile::Edge& edge)
+{
+    const auto& a = graph.Vertices[edge.Source];
+    const auto& b = graph.Vertices[edge.Target];
+
+    const float dx = b.X - a.X;
+    const float dy = b.Y - a.Y;
+    return sqrtf(dx * dx + dy * dy);
+}
+
+static CSRGraph BuildCSRGraph(const GraphFile& graph)
+{
+    CSRGraph csrGraph = CSRGraph::FromEdges((int)graph.Vertices.size(), graph.Edges.size(), [&graph](size_t index)
+    {
+        const auto& e = graph.Edges[index];
+        return CSREdge{ (int)e.Source, (int)e.Target, EdgeLength(graph, e) };
+    });
+
+    csrGraph.Positions.reserve(graph.Vertices.size());
+    for (const auto& vertex : graph.Vertices)
+        csrGraph.Positions.push_back({ vertex.X, vertex.Y });
+
+    return csrGraph;
+}
+
+static std::unique_ptr<Algorithm> CreateBenchAlgorithm(const AlgorithmType type, const BenchOptions& options)
+{
+    if (type == AlgorithmType::DeltaStepping)
+        return std::make_unique<DeltaStepping>(options.Delta);
+    if (type == AlgorithmType::DijkstraRadixHeap)
+        return std::make_unique<DijkstraRadixHeap>(options.Resolution);
+    if (type == AlgorithmType::DijkstraIndexedHeap)
+        return std::make_unique<DijkstraIndexedHeap>(options.Arity);
+
+    return CreateAlgorithm(type);
+}
+
+// threads is only applied to multithreaded algorithms, 0 leaves them at their default. counterGroup is null when the
+// hardware counters are off or unavailable.
+static BenchResult RunBenchmark(const AlgorithmType type, unsigned threads, const GraphFile& graphFile, const CSRGraph& graph,
+    const std::vector<std::pair<int, int>>& pairs, const BenchOptions& options, HardwareCounterGroup* counterGroup)
+{
+    BenchResult result;
+    result.Type = type;
+
+    std::unique_ptr<Algorithm> algorithm = CreateBenchAlgorithm(type, options);
+    if (threads > 0)
+        algorithm->SetThreadCount(threads);
+
+    result.Threads = algorithm->GetThreadCount();
+
+    if (type == AlgorithmType::DijkstraIndexedHeap)
+        result.Arity = static_cast<const DijkstraIndexedHeap&>(*algorithm).GetArity();
+
+    // Preprocessing is done once per graph and shared by every pair, so it is reported separately from the queries
+    if (algorithm->HasPreprocessing())
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        algorithm->Preprocess(graph);
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        result.PreprocessingNs = std::chrono::duration<double, std::nano>(end - start).count();
+        result.PreprocessedBytes = algorithm->GetPreprocessedBytes();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(pairs.size() * options.Repetitions);
+
+    size_t hardwarePairs[HardwareEventCount] = {};
+
+    for (const auto& [source, target] : pairs)
+    {
+        for (uint32_t run = 0; run < options.Warmup; run++)
+            algorithm->FindPath(graph, source, target);
+
+        if (counterGroup)
+            counterGroup->Start();
+
+        for (uint32_t run = 0; run < options.Repetitions; run++)
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+            algorithm->FindPath(graph, source, target);
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+
+        if (counterGroup)
+        {
+            const HardwareCounters hardware = counterGroup->Stop(options.Repetitions);
+            for (size_t event = 0; event < HardwareEventCount; event++)
+            {
+                if (!hardware.Available[event])
+                    continue;
+
+                result.Hardware.Available[event] = true;
+                result.Hardware.Values[event] += hardware.Values[event];
+                hardwarePairs[event]++;
+            }
+        }
+
+        const TraversalResult found = algorithm->GetResult();
+        if (source == target || !found.FinalEdges.empty())
+            result.PathsFound++;
+
+        for (const int edgeIndex : found.FinalEdges)
+            result.PathLength += EdgeLength(graphFile, graphFile.Edges[edgeIndex]);
+
+        if (found.SearchDistance >= 0.0f)
+            result.SearchDistance = std::max(result.SearchDistance, 0.0) + found.SearchDistance;
+
+        // Operation counters are only collected by the recorded run, outside of the measured region
+        algorithm->RecordPath(graph, source, target);
+        const OperationCounters counters = algorithm->GetResult().Counters;
+        result.Counters.Settled += counters.Settled;
+        result.Counters.Relaxations += counters.Relaxations;
+        result.Counters.SuccessfulRelaxations += counters.SuccessfulRelaxations;
+        result.Counters.QueuePushes += counters.QueuePushes;
+        result.Counters.QueuePops += counters.QueuePops;
+        result.Counters.Reinsertions += counters.Reinsertions;
+        result.Counters.PeakQueueSize = std::max(result.Counters.PeakQueueSize, counters.PeakQueueSize);
+    }
+
+    for (size_t event = 0; event < HardwareEventCount; event++)
+        if (hardwarePairs[event] > 0)
+            result.Hardware.Values[event] /= (double)hardwarePairs[event];
+
+    result.Timing = ComputeTimingStatistics(std::move(samples));
+    return result;
+}
+
+static std::string EscapeJson(const std::string& text)
+{
+    std::string escaped;
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+// Cycles, instructions, IPC and the miss counts, each followed by a separator. Counts that weren't measured are null in
+// JSON and empty in CSV.
+static std::string FormatHardwareCounters(const HardwareCounters& hardware, const OutputFormat format)
+{
+    std::string text;
+    char number[64];
+
+    auto append = [&](const char* name, bool available, double value, const char* precision)
+    {
+        if (available)
+            snprintf(number, sizeof(number), precision, value);
+
+        if (format == OutputFormat::Json)
+            text += std::string("\"") + name + "\": " + (available ? number : "null") + ", ";
+        else
+            text += std::string(available ? number : "") + ",";
+    };
+
+    for (const HardwareEvent event : { HardwareEvent::Cycles, HardwareEvent::Instructions })
+        append(HardwareEventToIdentifier(event), hardware.Has(event), hardware.Get(event), "%.0f");
+
+    append("ipc", hardware.GetIPC() > 0.0, hardware.GetIPC(), "%.3f");
+
+    for (const HardwareEvent event : { HardwareEvent::L1DMisses, HardwareEvent::LLCMisses, HardwareEvent::BranchMisses, HardwareEvent::DTLBMisses })
+        append(HardwareEventToIdentifier(event), hardware.Has(event), hardware.Get(event), "%.0f");
+
+    return text;
+}
+
+// Path length, search distance and the relative error between them, each followed by a separator. The last two are
+// null in JSON and empty in CSV for the algorithms that search on the exact weights.
+static std::string FormatPathLengths(const BenchResult& result, const OutputFormat format)
+{
+    std::string text;
+    char number[64];
+
+    auto append = [&](const char* name, bool available, double value, const char* precision)
+    {
+        if (available)
+            snprintf(number, sizeof(number), precision, value);
+
+        if (format == OutputFormat::Json)
+            text += std::string("\"") + name + "\": " + (available ? number : "null") + ", ";
+        else
+            text += std::string(available ? number : "") + ",";
+    };
+
+    const bool approximated = result.SearchDistance >= 0.0;
+    append("path_length", true, result.PathLength, "%.3f");
+    append("search_distance", approximated, result.SearchDistance, "%.3f");
+    append("relative_error", approximated && result.PathLength > 0.0, (result.SearchDistance - result.PathLength) / result.PathLength, "%.6f");
+
+    return text;
+}
+
+static void PrintJson(const BenchOptions& options, const GraphFile& graph, size_t pairCount, const std::vector<BenchResult>& results)
+{
+    printf("{\n");
+    printf("  \"graph\": \"%s\",\n", EscapeJson(options.GraphPath).c_str());
+    printf("  \"vertices\": %zu,\n", graph.Vertices.size());
+    printf("  \"edges\": %zu,\n", graph.Edges.size());
+    printf("  \"pairs\": %zu,\n", pairCount);
+    printf("  \"repetitions\": %u,\n", options.Repetitions);
+    printf("  \"warmup\": %u,\n", options.Warmup);
+    printf("  \"resolution\": %g,\n", options.Resolution);
+    printf("  \"results\": [\n");
+
+    for (size_t index = 0; index < results.size(); index++)
+    {
+        const auto& result = results[index];
+        const auto& timing = result.Timing;
+        const auto& counters = result.Counters;
+        const std::string arity = result.Arity > 0 ? std::to_string(result.Arity) : "null";
+        printf("    { \"algorithm\": \"%s\", \"threads\": %u, \"arity\": %s, \"samples\": %zu, \"paths_found\": %zu, %s"
+            "\"min_ns\": %.0f, \"median_ns\": %.0f, \"mean_ns\": %.0f, \"p95_ns\": %.0f, \"max_ns\": %.0f, \"stddev_ns\": %.0f, "
+            "\"preprocessing_ns\": %.0f, \"preprocessed_bytes\": %zu, \"settled\": %zu, \"relaxations\": %zu, "
+            "\"successful_relaxations\": %zu, \"queue_pushes\": %zu, \"queue_pops\": %zu, \"reinsertions\": %zu, \"peak_queue_size\": %zu, "
+            "%s\"speedup_vs_dijkstra_queue\": %.3f }%s\n",
+            AlgorithmTypeToIdentifier(result.Type), result.Threads, arity.c_str(), timing.Samples, result.PathsFound,
+            FormatPathLengths(result, OutputFormat::Json).c_str(), timing.Min, timing.Median, timing.Mean, timing.P95, timing.Max, timing.StdDev,
+            result.PreprocessingNs, result.PreprocessedBytes, counters.Settled, counters.Relaxations,
+            counters.SuccessfulRelaxations, counters.QueuePushes, counters.QueuePops, counters.Reinsertions, counters.PeakQueueSize,
+            FormatHardwareCounters(result.Hardware, OutputFormat::Json).c_str(), result.Speedup,
+            index + 1 < results.size() ? "," : "");
+    }
+
+    printf("  ]\n");
+    printf("}\n");
+}
+
+static void PrintCsv(const std::vector<BenchResult>& results)
+{
+    printf("algorithm,threads,arity,samples,paths_found,path_length,search_distance,relative_error,min_ns,median_ns,mean_ns,p95_ns,max_ns,stddev_ns,preprocessing_ns,preprocessed_bytes,"
+        "settled,relaxations,successful_relaxations,queue_pushes,queue_pops,reinsertions,peak_queue_size,"
+        "cycles,instructions,ipc,l1d_misses,llc_misses,branch_misses,dtlb_misses,speedup_vs_dijkstra_queue\n");
+
+    for (const auto& result : results)
+    {
+        const auto& timing = result.Timing;
+        const auto& counters = result.Counters;
+        const std::string arity = result.Arity > 0 ? std::to_string(result.Arity) : "";
+        printf("%s,%u,%s,%zu,%zu,%s%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%s%.3f\n",
+            AlgorithmTypeToIdentifier(result.Type), result.Threads, arity.c_str(), timing.Samples, result.PathsFound,
+            FormatPathLengths(result, OutputFormat::Csv).c_str(), timing.Min, timing.Median, timing.Mean, timing.P95, timing.Max, timing.StdDev,
+            result.PreprocessingNs, result.PreprocessedBytes, counters.Settled, counters.Relaxations,
+            counters.SuccessfulRelaxations, counters.QueuePushes, counters.QueuePops, counters.Reinsertions, counters.PeakQueueSize,
+            FormatHardwareCounters(result.Hardware, OutputFormat::Csv).c_str(), result.Speedup);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    GraphFile graphFile;
+    if (!LoadGraphFile(options.GraphPath.c_str(), graphFile))
+    {
+        std::cerr << "Could not load graph: " << options.GraphPath << std::endl;
+        return 1;
+    }
+
+    const int vertexCount = (int)graphFile.Vertices.size();
+    if (vertexCount == 0)
+    {
+        std::cerr << "Graph has no vertices" << std::endl;
+        return 1;
+    }
+
+    const CSRGraph graph = BuildCSRGraph(graphFile);
+    std::cerr << "Loaded " << vertexCount << " nodes and " << graphFile.Edges.size() << " edges\n";
+
+    std::vector<std::pair<int, int>> pairs;
+    if (options.Source >= 0)
+    {
+        if (options.Source >= vertexCount || options.Target >= vertexCount)
+        {
+            std::cerr << "Source/target out of range, graph has " << vertexCount << " vertices" << std::endl;
+            return 1;
+        }
+
+        pairs.emplace_back(options.Source, options.Target);
+    }
+    else
+    {
+        std::mt19937 rng(options.Seed);
+        std::uniform_int_distribution<int> vertexDist(0, vertexCount - 1);
+        for (uint32_t index = 0; index < options.Pairs; index++)
+            pairs.emplace_back(vertexDist(rng), vertexDist(rng));
+    }
+
+    // A thread sweep is reported as speedup over DijkstraQueue, so make sure there is a baseline to divide by
+    if (!options.ThreadCounts.empty() &&
+        std::find(options.Algorithms.begin(), options.Algorithms.end(), AlgorithmType::DijkstraQueue) == options.Algorithms.end())
+        options.Algorithms.insert(options.Algorithms.begin(), AlgorithmType::DijkstraQueue);
+
+    // Opened once and reused for every result, the output still has the columns (empty) when the counters are unavailable
+    std::unique_ptr<HardwareCounterGroup> counterGroup;
+    if (options.HardwareCounters)
+    {
+        counterGroup = std::make_unique<HardwareCounterGroup>();
+        if (!counterGroup->IsAvailable())
+        {
+            std::cerr << "Hardware counters unavailable, " << counterGroup->GetError() << std::endl;
+            counterGroup.reset();
+        }
+    }
+
+    std::vector<BenchResult> results;
+    for (const AlgorithmType type : options.Algorithms)
+    {
+        if (options.ThreadCounts.empty() || !CreateAlgorithm(type)->IsMultithreaded())
+        {
+            std::cerr << "Running " << AlgorithmTypeToIdentifier(type) << "..." << std::endl;
+            results.push_back(RunBenchmark(type, 0, graphFile, graph, pairs, options, counterGroup.get()));
+            continue;
+        }
+
+        for (const unsigned threads : options.ThreadCounts)
+        {
+            std::cerr << "Running " << AlgorithmTypeToIdentifier(type) << " on " << threads << " threads..." << std::endl;
+            results.push_back(RunBenchmark(type, threads, graphFile, graph, pairs, options, counterGroup.get()));
+        }
+    }
+
+    const auto baseline = std::find_if(results.begin(), results.end(), [](const BenchResult& result) { return result.Type == AlgorithmType::DijkstraQueue; });
+    if (baseline != results.end())
+    {
+        const double baselineMedian = baseline->Timing.Median;
+        for (auto& result : results)
+            result.Speedup = result.Timing.Median > 0.0 ? baselineMedian / result.Timing.Median : 0.0;
+    }
+
+    if (options.Format == OutputFormat::Json)
+        PrintJson(options, graphFile, pairs.size(), results);
+    else
+        PrintCsv(results);
+
+    return 0;
+}
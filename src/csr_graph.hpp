@@ -0,0 +1,153 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+using AdjacencyMatrix = std::vector<std::vector<std::pair<float, int>>>;
+
+struct CSREdge
+{
+	int A;
+	int B;
+	float Weight;
+};
+
+struct CSRPosition
+{
+	float X;
+	float Y;
+};
+
+// Compressed sparse row view of an undirected graph.
+// The neighbours of vertex u live in the range [Offsets[u], Offsets[u + 1]) of the flat arrays, sorted by neighbour id,
+// and every undirected edge is stored once from each of its endpoints.
+struct CSRGraph
+{
+	std::vector<int> Offsets;
+	std::vector<int> Neighbors;
+	std::vector<float> Weights;
+	std::vector<int> EdgeIndices;
+
+	// Optional vertex coordinates, left empty when the graph has no geometry.
+	// When set, no edge may be shorter than the straight line between its endpoints, goal directed searches rely on it.
+	std::vector<CSRPosition> Positions;
+
+	// Names the contents for preprocessed data, which must not be used on any other graph. Every graph that is built gets
+	// a new id and copies keep it, so a graph whose arrays are changed after preprocessing needs NewId() assigned again.
+	uint64_t Id = NewId();
+
+	static uint64_t NewId()
+	{
+		static std::atomic<uint64_t> next{ 1 };
+		return next.fetch_add(1);
+	}
+
+	inline int GetVertexCount() const { return Offsets.empty() ? 0 : (int)Offsets.size() - 1; }
+	inline int GetArcCount() const { return (int)Neighbors.size(); }
+	inline int GetDegree(int u) const { return Offsets[u + 1] - Offsets[u]; }
+	inline bool HasPositions() const { return !Positions.empty(); }
+
+	inline float StraightLineDistance(int u, int v) const
+	{
+		const float dx = Positions[v].X - Positions[u].X;
+		const float dy = Positions[v].Y - Positions[u].Y;
+		return sqrtf(dx * dx + dy * dy);
+	}
+
+	// Builds the graph from an undirected edge list, get_edge(index) must return a CSREdge.
+	// Self loops and edges without a positive weight are dropped, as they were never traversable in the dense matrix.
+	template <typename EdgeFn>
+	static CSRGraph FromEdges(int vertex_count, size_t edge_count, EdgeFn&& get_edge)
+	{
+		CSRGraph graph;
+		graph.Offsets.assign(vertex_count + 1, 0);
+
+		for (size_t index = 0; index < edge_count; index++)
+		{
+			const CSREdge edge = get_edge(index);
+			if (edge.A == edge.B || !(edge.Weight > 0.0f))
+				continue;
+
+			graph.Offsets[edge.A + 1]++;
+			graph.Offsets[edge.B + 1]++;
+		}
+
+		for (int u = 0; u < vertex_count; u++)
+			graph.Offsets[u + 1] += graph.Offsets[u];
+
+		const size_t arc_count = graph.Offsets.back();
+
+		// Bucket every arc by its target first, since the graph is symmetric this is the same shape as the final layout
+		std::vector<int> sources(arc_count);
+		std::vector<int> source_edges(arc_count);
+		std::vector<float> source_weights(arc_count);
+		std::vector<int> cursor(graph.Offsets.begin(), graph.Offsets.end() - 1);
+
+		for (size_t index = 0; index < edge_count; index++)
+		{
+			const CSREdge edge = get_edge(index);
+			if (edge.A == edge.B || !(edge.Weight > 0.0f))
+				continue;
+
+			const int a = cursor[edge.B]++;
+			sources[a] = edge.A;
+			source_edges[a] = (int)index;
+			source_weights[a] = edge.Weight;
+
+			const int b = cursor[edge.A]++;
+			sources[b] = edge.B;
+			source_edges[b] = (int)index;
+			source_weights[b] = edge.Weight;
+		}
+
+		// Then scatter them back by source in ascending target order, leaving each row sorted by neighbour id
+		graph.Neighbors.resize(arc_count);
+		graph.Weights.resize(arc_count);
+		graph.EdgeIndices.resize(arc_count);
+		std::copy(graph.Offsets.begin(), graph.Offsets.end() - 1, cursor.begin());
+
+		for (int v = 0; v < vertex_count; v++)
+		{
+			for (int i = graph.Offsets[v]; i < graph.Offsets[v + 1]; i++)
+			{
+				const int slot = cursor[sources[i]]++;
+				graph.Neighbors[slot] = v;
+				graph.Weights[slot] = source_weights[i];
+				graph.EdgeIndices[slot] = source_edges[i];
+			}
+		}
+
+		return graph;
+	}
+
+	// Compresses a dense matrix where a non-positive weight means "no edge"
+	static CSRGraph FromAdjacencyMatrix(const AdjacencyMatrix& matrix)
+	{
+		CSRGraph graph;
+		graph.Offsets.reserve(matrix.size() + 1);
+		graph.Offsets.push_back(0);
+
+		for (size_t u = 0; u < matrix.size(); u++)
+		{
+			for (size_t v = 0; v < matrix[u].size(); v++)
+			{
+				const auto [weight, edge_index] = matrix[u][v];
+				if (u == v || !(weight > 0.0f))
+					continue;
+
+				graph.Neighbors.push_back((int)v);
+				graph.Weights.push_back(weight);
+				graph.EdgeIndices.push_back(edge_index);
+			}
+
+			graph.Offsets.push_back((int)graph.Neighbors.size());
+		}
+
+		return graph;
+	}
+};
@@ -0,0 +1,55 @@
+#include "graph_file.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+bool LoadGraphFile(const char* filepath, GraphFile& graph)
+{
+	if (!filepath || strlen(filepath) == 0)
+		return false;
+
+	if (!std::filesystem::exists(filepath))
+		return false;
+
+	GraphFile result;
+
+	try
+	{
+		const YAML::Node config = YAML::LoadFile(filepath);
+
+		for (const auto& node : config["nodes"])
+		{
+			const float x = node["x"].as<float>();
+			const float y = node["y"].as<float>();
+			result.Vertices.push_back({ x, y });
+		}
+
+		for (const auto& edge : config["edges"])
+		{
+			const auto nameNode = edge["name"];
+			const uint32_t source = edge["source"].as<uint32_t>();
+			const uint32_t target = edge["target"].as<uint32_t>();
+			result.Edges.push_back({ nameNode ? nameNode.as<std::string>() : std::string(), source, target });
+		}
+	}
+	catch (...)
+	{
+		std::cerr << "Failed to load graph visualizer file: " << filepath << std::endl;
+		return false;
+	}
+
+	for (const auto& edge : result.Edges)
+	{
+		if (edge.Source >= result.Vertices.size() || edge.Target >= result.Vertices.size())
+		{
+			std::cerr << "Graph visualizer file references a missing vertex: " << filepath << std::endl;
+			return false;
+		}
+	}
+
+	graph = std::move(result);
+	return true;
+}
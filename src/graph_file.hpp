@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Plain in-memory form of a .algograph file, free of any ImGui/GL types so headless tools can share the loader
+struct GraphFile
+{
+	struct Vertex
+	{
+		float X;
+		float Y;
+	};
+
+	struct Edge
+	{
+		std::string Name;
+		uint32_t Source;
+		uint32_t Target;
+	};
+
+	std::vector<Vertex> Vertices;
+	std::vector<Edge> Edges;
+};
+
+// Returns false (and leaves graph untouched) if the file is missing or malformed
+bool LoadGraphFile(const char* filepath, GraphFile& graph);
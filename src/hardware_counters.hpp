@@ -0,0 +1,325 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// CPU events counted around the timed searches, through Linux perf_event groups on the calling thread and the
+// ThreadTeam workers that run its tasks
+enum class HardwareEvent
+{
+	Cycles,
+	Instructions,
+	L1DMisses,
+	LLCMisses,
+	BranchMisses,
+	DTLBMisses,
+	Count
+};
+
+static constexpr size_t HardwareEventCount = (size_t)HardwareEvent::Count;
+
+inline const char* HardwareEventToString(const HardwareEvent event)
+{
+	switch (event)
+	{
+	case HardwareEvent::Cycles: return "Cycles";
+	case HardwareEvent::Instructions: return "Instructions";
+	case HardwareEvent::L1DMisses: return "L1D Misses";
+	case HardwareEvent::LLCMisses: return "LLC Misses";
+	case HardwareEvent::BranchMisses: return "Branch Misses";
+	case HardwareEvent::DTLBMisses: return "dTLB Misses";
+	default: return "Unknown";
+	}
+}
+
+// Column and field names in gv-bench's output
+inline const char* HardwareEventToIdentifier(const HardwareEvent event)
+{
+	switch (event)
+	{
+	case HardwareEvent::Cycles: return "cycles";
+	case HardwareEvent::Instructions: return "instructions";
+	case HardwareEvent::L1DMisses: return "l1d_misses";
+	case HardwareEvent::LLCMisses: return "llc_misses";
+	case HardwareEvent::BranchMisses: return "branch_misses";
+	case HardwareEvent::DTLBMisses: return "dtlb_misses";
+	default: return "unknown";
+	}
+}
+
+// Event counts per run, events the CPU or the kernel doesn't offer are left unavailable
+struct HardwareCounters
+{
+	bool Available[HardwareEventCount] = {};
+	double Values[HardwareEventCount] = {};
+
+	bool Has(const HardwareEvent event) const { return Available[(size_t)event]; }
+	double Get(const HardwareEvent event) const { return Values[(size_t)event]; }
+
+	bool Any() const
+	{
+		for (const bool available : Available)
+			if (available)
+				return true;
+		return false;
+	}
+
+	// Instructions per cycle, 0 when either count is missing
+	double GetIPC() const
+	{
+		if (!Has(HardwareEvent::Cycles) || !Has(HardwareEvent::Instructions) || Get(HardwareEvent::Cycles) <= 0.0)
+			return 0.0;
+		return Get(HardwareEvent::Instructions) / Get(HardwareEvent::Cycles);
+	}
+};
+
+class HardwareCounterGroup;
+
+// The group the calling thread is counting for between Start and Stop, null otherwise. ThreadTeam hands it to its
+// workers, which attach to it before running the task.
+inline thread_local HardwareCounterGroup* t_HardwareCounting = nullptr;
+
+// One perf_event group of all the events, opened once and reused for every measurement. Only user space of the thread
+// that created it is counted, which is what perf_event_paranoid 2 (the usual default) still allows for the process's
+// own threads. Worker threads of the multithreaded algorithms get a group of their own when they first run a task
+// while this one is counting (AttachCurrentThread), and Stop sums all of them, like perf stat over the process.
+// When perf_event_open is missing or refused (other systems, containers without the syscall, a stricter paranoid
+// level) the group is unavailable and GetError() says why, Start/Stop then do nothing. Events that fail on their own
+// (often the cache events in a VM) are left out of the group.
+class HardwareCounterGroup
+{
+public:
+	HardwareCounterGroup()
+	{
+		for (int& descriptor : m_Descriptors)
+			descriptor = -1;
+
+#if defined(__linux__)
+		int firstError = 0;
+		for (size_t event = 0; event < HardwareEventCount; event++)
+		{
+			perf_event_attr attributes;
+			memset(&attributes, 0, sizeof(attributes));
+			attributes.size = sizeof(attributes);
+			DescribeEvent((HardwareEvent)event, attributes);
+			attributes.disabled = m_Leader == -1 ? 1 : 0;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+			attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+			const int descriptor = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, m_Leader, 0);
+			if (descriptor == -1)
+			{
+				if (firstError == 0)
+					firstError = errno;
+				continue;
+			}
+
+			if (ioctl(descriptor, PERF_EVENT_IOC_ID, &m_Ids[event]) == -1)
+			{
+				close(descriptor);
+				continue;
+			}
+
+			m_Descriptors[event] = descriptor;
+			if (m_Leader == -1)
+				m_Leader = descriptor;
+		}
+
+		if (m_Leader == -1)
+		{
+			m_Error = std::string("perf_event_open failed: ") + strerror(firstError);
+			if (firstError == EACCES || firstError == EPERM)
+				m_Error += " (see /proc/sys/kernel/perf_event_paranoid)";
+			else if (firstError == ENOSYS)
+				m_Error += " (the kernel or the container doesn't allow the syscall)";
+			else if (firstError == ENOENT || firstError == EOPNOTSUPP)
+				m_Error += " (no hardware PMU, common in virtual machines)";
+		}
+#else
+		m_Error = "Hardware counters need Linux perf_event";
+#endif
+	}
+
+	~HardwareCounterGroup()
+	{
+#if defined(__linux__)
+		for (const int descriptor : m_Descriptors)
+			if (descriptor != -1)
+				close(descriptor);
+#endif
+	}
+
+	HardwareCounterGroup(const HardwareCounterGroup&) = delete;
+	HardwareCounterGroup& operator=(const HardwareCounterGroup&) = delete;
+
+	bool IsAvailable() const { return m_Leader != -1; }
+	const std::string& GetError() const { return m_Error; }
+
+	// Starts counting on the calling thread and on every worker attached so far
+	void Start()
+	{
+		if (m_Leader == -1)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_WorkersMutex);
+			for (const auto& worker : m_Workers)
+				worker->Enable();
+		}
+
+		Enable();
+		t_HardwareCounting = this;
+	}
+
+	// Counts since Start summed over the calling thread and the attached workers, divided by the number of runs in
+	// between. If the PMU had to share the counters with other groups the counts are scaled up to the whole enabled
+	// time, as perf does, for every thread on its own.
+	HardwareCounters Stop(size_t runs = 1)
+	{
+		if (m_Leader == -1)
+			return {};
+
+		t_HardwareCounting = nullptr;
+		HardwareCounters counters = Disable(runs);
+
+		std::lock_guard<std::mutex> lock(m_WorkersMutex);
+		for (const auto& worker : m_Workers)
+		{
+			const HardwareCounters workerCounters = worker->Disable(runs);
+			for (size_t event = 0; event < HardwareEventCount; event++)
+			{
+				if (counters.Available[event] && workerCounters.Available[event])
+					counters.Values[event] += workerCounters.Values[event];
+			}
+		}
+
+		return counters;
+	}
+
+	// Called on a worker thread before it runs a task for the thread that is counting. The first time, it opens a group
+	// for the worker and starts it right away, afterwards Start and Stop take care of it. The groups outlive the workers
+	// (a thread that exited simply counts nothing more), so a ThreadTeam can be replaced between measurements.
+	void AttachCurrentThread()
+	{
+		thread_local uint64_t attachedTo = 0;
+		if (attachedTo == m_Id)
+			return;
+		attachedTo = m_Id;
+
+		auto worker = std::make_unique<HardwareCounterGroup>();
+		if (!worker->IsAvailable())
+			return;
+
+		worker->Enable();
+
+		std::lock_guard<std::mutex> lock(m_WorkersMutex);
+		m_Workers.push_back(std::move(worker));
+	}
+
+private:
+	void Enable()
+	{
+#if defined(__linux__)
+		ioctl(m_Leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(m_Leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+	}
+
+	HardwareCounters Disable(size_t runs)
+	{
+		HardwareCounters counters;
+
+#if defined(__linux__)
+		ioctl(m_Leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+		// { nr, time_enabled, time_running, { value, id }[nr] }
+		uint64_t buffer[3 + 2 * HardwareEventCount] = {};
+		if (read(m_Leader, buffer, sizeof(buffer)) <= 0)
+			return counters;
+
+		const uint64_t count = buffer[0];
+		const uint64_t enabled = buffer[1];
+		const uint64_t running = buffer[2];
+
+		// A group that never got onto the PMU counted nothing
+		if (running == 0)
+			return counters;
+
+		const double scale = (double)enabled / (double)running / (double)(runs > 0 ? runs : 1);
+		for (uint64_t index = 0; index < count && index < HardwareEventCount; index++)
+		{
+			const uint64_t value = buffer[3 + 2 * index];
+			const uint64_t id = buffer[4 + 2 * index];
+
+			for (size_t event = 0; event < HardwareEventCount; event++)
+			{
+				if (m_Descriptors[event] != -1 && m_Ids[event] == id)
+				{
+					counters.Available[event] = true;
+					counters.Values[event] = (double)value * scale;
+				}
+			}
+		}
+#else
+		(void)runs;
+#endif
+
+		return counters;
+	}
+
+#if defined(__linux__)
+	static void DescribeEvent(const HardwareEvent event, perf_event_attr& attributes)
+	{
+		auto cacheMiss = [&](uint64_t cache)
+		{
+			attributes.type = PERF_TYPE_HW_CACHE;
+			attributes.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		};
+
+		attributes.type = PERF_TYPE_HARDWARE;
+		switch (event)
+		{
+		case HardwareEvent::Cycles: attributes.config = PERF_COUNT_HW_CPU_CYCLES; break;
+		case HardwareEvent::Instructions: attributes.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+		case HardwareEvent::L1DMisses: cacheMiss(PERF_COUNT_HW_CACHE_L1D); break;
+		// The generic cache-misses event, which the kernel maps to last level cache misses
+		case HardwareEvent::LLCMisses: attributes.config = PERF_COUNT_HW_CACHE_MISSES; break;
+		case HardwareEvent::BranchMisses: attributes.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+		case HardwareEvent::DTLBMisses: cacheMiss(PERF_COUNT_HW_CACHE_DTLB); break;
+		default: break;
+		}
+	}
+#endif
+
+	static uint64_t NextId()
+	{
+		static std::atomic<uint64_t> next{ 1 };
+		return next.fetch_add(1);
+	}
+
+	int m_Leader = -1;
+	int m_Descriptors[HardwareEventCount];
+	uint64_t m_Ids[HardwareEventCount] = {};
+	std::string m_Error;
+
+	// Tells groups apart for AttachCurrentThread even when one is allocated where an earlier one was
+	const uint64_t m_Id = NextId();
+
+	std::mutex m_WorkersMutex;
+	std::vector<std::unique_ptr<HardwareCounterGroup>> m_Workers;
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+// Min-heap over the ids [0, capacity) with a d-ary layout and a position map, so every id is in the heap at most once
+// and its key can be lowered in place (decrease-key) instead of pushing a duplicate entry.
+// Wider nodes make the heap shallower, trading more comparisons per sift down for fewer cache lines per sift up.
+template <typename Key, unsigned Arity = 4>
+class IndexedDaryHeap
+{
+	static_assert(Arity >= 2, "A heap needs at least two children per node");
+
+public:
+	explicit IndexedDaryHeap(int capacity = 0) { Reset(capacity); }
+
+	// Empties the heap and resizes the position map for ids in [0, capacity). With the same capacity as before only the
+	// ids still in the heap are cleared from the map, every other id was cleared when it was popped.
+	void Reset(int capacity)
+	{
+		if ((int)m_Position.size() == capacity)
+		{
+			for (const Entry& entry : m_Heap)
+				m_Position[entry.second] = NotInHeap;
+		}
+		else
+		{
+			m_Position.assign(capacity, NotInHeap);
+		}
+
+		m_Heap.clear();
+	}
+
+	inline bool Empty() const { return m_Heap.empty(); }
+	inline size_t Size() const { return m_Heap.size(); }
+	inline bool Contains(int id) const { return m_Position[id] != NotInHeap; }
+
+	inline int Top() const { return m_Heap.front().second; }
+	inline Key TopKey() const { return m_Heap.front().first; }
+
+	void Push(int id, Key key)
+	{
+		m_Position[id] = (int)m_Heap.size();
+		m_Heap.emplace_back(key, id);
+		SiftUp(m_Position[id]);
+	}
+
+	// key must not be larger than the current key of id
+	void DecreaseKey(int id, Key key)
+	{
+		const int position = m_Position[id];
+		m_Heap[position].first = key;
+		SiftUp(position);
+	}
+
+	// Inserts id or lowers its key, returns true when it was inserted
+	bool PushOrDecrease(int id, Key key)
+	{
+		if (Contains(id))
+		{
+			DecreaseKey(id, key);
+			return false;
+		}
+
+		Push(id, key);
+		return true;
+	}
+
+	int Pop()
+	{
+		const int top = m_Heap.front().second;
+		m_Position[top] = NotInHeap;
+
+		const Entry last = m_Heap.back();
+		m_Heap.pop_back();
+
+		if (!m_Heap.empty())
+		{
+			m_Heap.front() = last;
+			m_Position[last.second] = 0;
+			SiftDown(0);
+		}
+
+		return top;
+	}
+
+private:
+	using Entry = std::pair<Key, int>;
+	static constexpr int NotInHeap = -1;
+
+	void SiftUp(int position)
+	{
+		const Entry entry = m_Heap[position];
+		while (position > 0)
+		{
+			const int parent = (position - 1) / (int)Arity;
+			if (!(entry.first < m_Heap[parent].first))
+				break;
+
+			m_Heap[position] = m_Heap[parent];
+			m_Position[m_Heap[position].second] = position;
+			position = parent;
+		}
+
+		m_Heap[position] = entry;
+		m_Position[entry.second] = position;
+	}
+
+	void SiftDown(int position)
+	{
+		const Entry entry = m_Heap[position];
+		const int size = (int)m_Heap.size();
+
+		while (true)
+		{
+			const int first_child = position * (int)Arity + 1;
+			if (first_child >= size)
+				break;
+
+			const int last_child = first_child + (int)Arity < size ? first_child + (int)Arity : size;
+
+			int smallest = first_child;
+			for (int child = first_child + 1; child < last_child; child++)
+			{
+				if (m_Heap[child].first < m_Heap[smallest].first)
+					smallest = child;
+			}
+
+			if (!(m_Heap[smallest].first < entry.first))
+				break;
+
+			m_Heap[position] = m_Heap[smallest];
+			m_Position[m_Heap[position].second] = position;
+			position = smallest;
+		}
+
+		m_Heap[position] = entry;
+		m_Position[entry.second] = position;
+	}
+
+	std::vector<Entry> m_Heap;
+	std::vector<int> m_Position;
+};
@@ -40,6 +40,9 @@
 #include "text_symbols.hpp"
 
 #include "memory_tracker.hpp"
+#include "graph_file.hpp"
+#include "timing_statistics.hpp"
+#include "hardware_counters.hpp"
 
 #include "algorithm.hpp"
 #include "algorithms/BFS.hpp"
@@ -49,13 +52,24 @@
 #include "algorithms/DEsopoPape.hpp"
 #include "algorithms/BellmanFord.hpp"
 #include "algorithms/FloydWarshall.hpp"
+#include "algorithms/BidirectionalDijkstra.hpp"
+#include "algorithms/AStar.hpp"
+#include "algorithms/ALT.hpp"
+#include "algorithms/ContractionHierarchies.hpp"
+#include "algorithms/DijkstraIndexedHeap.hpp"
+#include "algorithms/DijkstraRadixHeap.hpp"
+#include "algorithms/DeltaStepping.hpp"
+#include "algorithms/DirectionOptimizingBFS.hpp"
+#include "algorithms/Johnson.hpp"
 
 #include <vector>
+#include <string>
 #include <unordered_set>
 #include <queue>
 #include <fstream>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 
 #include <yaml-cpp/yaml.h>
 #include <tinyfiledialogs.h>
@@ -326,6 +340,30 @@ static bool s_ShowFinalPaths = true;
 static bool s_TrackMemory = true;
 static float s_MemoryTrackingInterval = 10.0f; // ms
 
+static bool s_TrackHardwareCounters = true;
+
+// Opened on first use, on the thread that times the algorithms
+static HardwareCounterGroup& GetHardwareCounterGroup()
+{
+    static HardwareCounterGroup group;
+    return group;
+}
+
+// Which timing statistic the "Execution Time" column shows, the timeline always uses the median
+enum class TimingDisplay
+{
+    SingleShot,
+    Min,
+    Median,
+    P95,
+};
+
+static const char* s_TimingDisplayNames[] = { "Single Shot", "Min", "Median", "P95" };
+
+static int s_TimingWarmupRuns = 2;
+static int s_TimingRepetitions = 9;
+static TimingDisplay s_TimingDisplay = TimingDisplay::Median;
+
 enum class DragType
 {
     None,
@@ -361,6 +399,15 @@ static std::array<ImVec4, AlgorithmTypeCount> s_AlgorithmCompletedColors = {{
     { 0.905f, 0.072f, 0.940f, 1.0f },
     { 0.972f, 0.965f, 0.118f, 1.0f },
     { 0.080f, 0.859f, 0.821f, 1.0f },
+    { 0.180f, 0.800f, 0.443f, 1.0f },
+    { 0.988f, 0.514f, 0.675f, 1.0f },
+    { 0.608f, 0.349f, 0.714f, 1.0f },
+    { 0.596f, 0.463f, 0.329f, 1.0f },
+    { 0.231f, 0.380f, 0.949f, 1.0f },
+    { 0.851f, 0.584f, 0.263f, 1.0f },
+    { 0.553f, 0.851f, 0.247f, 1.0f },
+    { 0.878f, 0.400f, 0.702f, 1.0f },
+    { 0.400f, 0.659f, 0.820f, 1.0f },
 }};
 
 static std::array<ImVec4, AlgorithmTypeCount> s_AlgorithmTraversedColors;
@@ -432,24 +479,81 @@ static GLuint instance_vbo = 0;
 static GLuint line_shader = 0;
 static GLuint line_vao = 0;
 static GLuint line_vbo = 0;
+static GLuint edge_instance_vbo = 0;
+
+// Uniform buffers, bound once to these binding points and shared by every shader that declares the block
+static constexpr GLuint ViewUniformsBinding = 0;
+static constexpr GLuint AlgorithmUniformsBinding = 1;
+static GLuint view_ubo = 0;
+static GLuint algorithm_ubo = 0;
+
+// std140 mirror of the ViewUniforms block, rewritten only when a field changes
+struct ViewUniforms
+{
+    ImVec2 ViewportSize;
+    ImVec2 ViewportOffset;
+    float ViewportZoom = 1.0f;
+    float EdgeThickness = 0.0f;
+    float VertexRadius = 0.0f;
+    float Time = 0.0f;
+    GLint ShowTraversalPaths = 0;
+    GLint ShowFinalPaths = 0;
+    float Padding[2] = {};
+
+    bool operator==(const ViewUniforms& other) const { return memcmp(this, &other, sizeof(ViewUniforms)) == 0; }
+    bool operator!=(const ViewUniforms& other) const { return !(*this == other); }
+};
+
+static_assert(sizeof(ViewUniforms) == 48, "ViewUniforms must match the std140 layout of the block");
+
+// std140 mirror of one AlgorithmParameters entry of the AlgorithmUniforms block, new per algorithm parameters go here
+struct AlgorithmUniforms
+{
+    ImVec4 TraversalColor;
+    ImVec4 CompletedColor;
+    GLint Visible = 0;
+    float Thickness = 0.0f;
+    float Duration = 0.0f;
+    float Padding = 0.0f;
+};
+
+static_assert(sizeof(AlgorithmUniforms) == 48, "AlgorithmUniforms must match the std140 layout of the block");
+
+static ViewUniforms s_ViewUniforms;
 
 struct VertexInstance
 {
     ImVec2 Position;
 };
 
-struct EdgeVertex
+// Per algorithm timings are packed four to a vec4 attribute, GL only guarantees 16 attribute locations
+static constexpr size_t AlgorithmSlotCount = (AlgorithmTypeCount + 3) / 4;
+
+// Edge timings are fractions of the algorithm's own duration as 16 bit unorm, the shader scales them back with the
+// Duration of the algorithm's AlgorithmParameters in the AlgorithmUniforms block. 0 means the edge was never reached,
+// fractions map onto [1, 65535].
+using EdgeTime = uint16_t;
+static constexpr EdgeTime EdgeTimeNotReached = 0;
+
+static EdgeTime EncodeEdgeTime(const double fraction)
 {
-    ImVec2 Position;
-    ImVec2 Normal;
-    std::array<float, AlgorithmTypeCount> TraversalTimes{};
-    std::array<float, AlgorithmTypeCount> CompletionTimes{};
+    const double clamped = fraction < 0.0 ? 0.0 : (fraction > 1.0 ? 1.0 : fraction);
+    return (EdgeTime)(1.0 + clamped * 65534.0 + 0.5);
+}
+
+// One per source edge, at the same index, drawn as an instance of the edge quad so the timings are stored once per edge
+struct EdgeInstance
+{
+    ImVec2 A;
+    ImVec2 B;
+    std::array<EdgeTime, AlgorithmSlotCount * 4> TraversalTimes{};
+    std::array<EdgeTime, AlgorithmSlotCount * 4> CompletionTimes{};
 
-    EdgeVertex(const ImVec2& position, const ImVec2& normal)
-        : Position(position), Normal(normal)
+    EdgeInstance(const ImVec2& a, const ImVec2& b)
+        : A(a), B(b)
     {
-        TraversalTimes.fill(-1.0f);
-        CompletionTimes.fill(-1.0f);
+        TraversalTimes.fill(EdgeTimeNotReached);
+        CompletionTimes.fill(EdgeTimeNotReached);
     }
 };
 
@@ -479,17 +583,53 @@ struct SourceGraph
 struct DrawGraphAlgorithmMetadata
 {
     bool Valid = false;
-    float Duration = 0.0f;
+    float Duration = 0.0f; // Median of the measured repetitions
+    float SingleShotDuration = 0.0f; // First, cold run of the search
+    float RecordedDuration = 0.0f;
+    TimingStatistics Timing;
+    bool Preprocessed = false;
+    float PreprocessingDuration = 0.0f;
+    bool PreprocessingReused = false; // Built by an earlier query on the same graph, PreprocessingDuration is that build's
+    size_t PreprocessedBytes = 0;
+    OperationCounters Counters;
+    HardwareCounters Hardware; // Per measured run, empty when perf counters are off or unavailable
+    unsigned Threads = 1;
     float TotalDistance = 0.0f;
-    size_t PeakMemoryUsage = 0.0f;
+    float SearchDistance = -1.0f; // The algorithm's own path length when it searched on approximated weights
+    size_t PeakMemoryUsage = 0; // High-water mark of the live heap bytes during the tracked run
     float GraphTraversalPercentage = 0.0f;
     std::vector<size_t> MemoryTrackingData;
 };
 
+// Algorithms that compute the same all-pairs table and are compared with each other, Count for the rest
+static AlgorithmType GetAllPairsCounterpart(const AlgorithmType type)
+{
+    switch (type)
+    {
+    case AlgorithmType::FloydWarshall: return AlgorithmType::Johnson;
+    case AlgorithmType::Johnson: return AlgorithmType::FloydWarshall;
+    default: return AlgorithmType::Count;
+    }
+}
+
+static float GetDisplayedDuration(const DrawGraphAlgorithmMetadata& metadata)
+{
+    switch (s_TimingDisplay)
+    {
+    case TimingDisplay::SingleShot: return metadata.SingleShotDuration;
+    case TimingDisplay::Min: return (float)metadata.Timing.Min;
+    case TimingDisplay::Median: return (float)metadata.Timing.Median;
+    case TimingDisplay::P95: return (float)metadata.Timing.P95;
+    }
+
+    return metadata.Duration;
+}
+
 struct DrawGraph
 {
     std::vector<VertexInstance> Vertices;
-    std::vector<EdgeVertex> EdgeVertices;
+    std::vector<EdgeInstance> EdgeInstances;
+    std::vector<std::vector<uint32_t>> IncidentEdges; // Per vertex, so moving a vertex only patches its own edges
     float Duration;
 
     std::array<DrawGraphAlgorithmMetadata, AlgorithmTypeCount> Metadata;
@@ -498,6 +638,22 @@ struct DrawGraph
 static SourceGraph s_SourceGraph;
 static DrawGraph s_DrawGraph;
 
+// Bumped by every edit of s_SourceGraph, the CSR graph and the preprocessing built from it are only redone when it changes
+static uint64_t s_GraphGeneration = 1;
+
+// Records of s_DrawGraph patched since the last upload, FlushDrawGraphEdits uploads only these
+struct DrawGraphEdits
+{
+    std::vector<uint32_t> Vertices;
+    std::vector<uint32_t> Edges;
+};
+
+static DrawGraphEdits s_DrawGraphEdits;
+
+// Records the GPU buffers have room for, appended records fit without reallocating until they run out
+static size_t s_VertexBufferCapacity = 0;
+static size_t s_EdgeBufferCapacity = 0;
+
 static void RegenerateGraph();
 static void RegenerateTimedGraph();
 
@@ -508,24 +664,40 @@ static float Distance(const ImVec2& a, const ImVec2& b)
     return sqrtf(dx * dx + dy * dy);
 }
 
-static void RecomputeTraversalGPUData()
+// Called whenever an algorithm's color, visibility or thickness changes, or a new graph brings new durations
+static void UpdateAlgorithmUniforms()
 {
+	std::array<AlgorithmUniforms, AlgorithmTypeCount> uniforms;
 	for (size_t index = 0; index < AlgorithmTypeCount; index++)
-		s_AlgorithmTraversedColors[index] = s_AlgorithmCompletedColors[index] * 0.4f + ImVec4(0.6f, 0.6f, 0.6f, 1.0f);
+	{
+		uniforms[index].TraversalColor = s_AlgorithmTraversedColors[index];
+		uniforms[index].CompletedColor = s_AlgorithmCompletedColors[index];
+		uniforms[index].Visible = s_AlgorithmVisible[index];
+		uniforms[index].Thickness = s_AlgorithmThickness[index];
 
-    glUseProgram(line_shader);
+		// The edge timings are relative to this
+		uniforms[index].Duration = s_DrawGraph.Metadata[index].Duration;
+	}
 
-	GLint traversal_colors_loc = glGetUniformLocation(line_shader, "u_TraversalColors");
-	glUniform4fv(traversal_colors_loc, AlgorithmTypeCount, (const GLfloat*)s_AlgorithmTraversedColors.data());
+	glBindBuffer(GL_UNIFORM_BUFFER, algorithm_ubo);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(uniforms), uniforms.data());
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
 
-	GLint completed_colors_loc = glGetUniformLocation(line_shader, "u_CompletedColors");
-	glUniform4fv(completed_colors_loc, AlgorithmTypeCount, (const GLfloat*)s_AlgorithmCompletedColors.data());
+static void RecomputeTraversalGPUData()
+{
+	for (size_t index = 0; index < AlgorithmTypeCount; index++)
+		s_AlgorithmTraversedColors[index] = s_AlgorithmCompletedColors[index] * 0.4f + ImVec4(0.6f, 0.6f, 0.6f, 1.0f);
+
+	UpdateAlgorithmUniforms();
+}
 
-	GLint visible_loc = glGetUniformLocation(line_shader, "u_Visible");
-	glUniform1iv(visible_loc, AlgorithmTypeCount, s_AlgorithmVisible.data());
+static void ResetPlayback();
 
-	GLint thicknesses_loc = glGetUniformLocation(line_shader, "u_Thicknesses");
-	glUniform1fv(thicknesses_loc, AlgorithmTypeCount, s_AlgorithmThickness.data());
+// Edits patch s_DrawGraph in place, but the first edit after a timing run rebuilds it to drop the timings it invalidates
+static bool HasTimings(const DrawGraph& graph)
+{
+	return std::any_of(graph.Metadata.begin(), graph.Metadata.end(), [](const DrawGraphAlgorithmMetadata& metadata) { return metadata.Valid; });
 }
 
 static void AddVertex(const ImVec2& position)
@@ -533,10 +705,48 @@ static void AddVertex(const ImVec2& position)
 	VertexInstance v;
 	v.Position = position;
 	s_SourceGraph.Vertices.push_back(v);
+	s_GraphGeneration++;
 
-    RegenerateGraph();
+	if (HasTimings(s_DrawGraph))
+	{
+		RegenerateGraph();
+		return;
+	}
+
+	s_DrawGraph.Vertices.push_back(v);
+	s_DrawGraph.IncidentEdges.emplace_back();
+	s_DrawGraphEdits.Vertices.push_back((uint32_t)s_DrawGraph.Vertices.size() - 1);
+	ResetPlayback();
 }
 
+// Costs O(degree) on an untimed graph, only the vertex and its incident edges are patched and uploaded
+static void MoveVertex(const int index, const ImVec2& position)
+{
+	s_SourceGraph.Vertices[index].Position = position;
+	s_GraphGeneration++;
+
+	if (HasTimings(s_DrawGraph))
+	{
+		RegenerateGraph();
+		return;
+	}
+
+	s_DrawGraph.Vertices[index].Position = position;
+	s_DrawGraphEdits.Vertices.push_back(index);
+
+	for (const uint32_t edgeIndex : s_DrawGraph.IncidentEdges[index])
+	{
+		const Edge& edge = s_SourceGraph.Edges[edgeIndex];
+		EdgeInstance& instance = s_DrawGraph.EdgeInstances[edgeIndex];
+		instance.A = s_SourceGraph.Vertices[edge.IndexA].Position;
+		instance.B = s_SourceGraph.Vertices[edge.IndexB].Position;
+		s_DrawGraphEdits.Edges.push_back(edgeIndex);
+	}
+
+	ResetPlayback();
+}
+
+// Deletions shift the indices of every later vertex and edge, so they rebuild the draw graph
 static void DeleteVertex(const int index)
 {
 	if (index < 0 || index >= (int)s_SourceGraph.Vertices.size())
@@ -567,9 +777,10 @@ static void AddEdge(const int indexA, const int indexB)
 	if (indexA == indexB || indexA < 0 || indexB < 0 || indexA >= (int)s_SourceGraph.Vertices.size() || indexB >= (int)s_SourceGraph.Vertices.size())
 		return;
 
-	// Prevent duplicate edges
-	for (const auto& e : s_SourceGraph.Edges)
+	// Prevent duplicate edges, any edge between the two is incident to A
+	for (const uint32_t edgeIndex : s_DrawGraph.IncidentEdges[indexA])
 	{
+		const auto& e = s_SourceGraph.Edges[edgeIndex];
 		if ((e.IndexA == indexA && e.IndexB == indexB) || (e.IndexA == indexB && e.IndexB == indexA))
 			return;
 	}
@@ -578,8 +789,20 @@ static void AddEdge(const int indexA, const int indexB)
 	edge.IndexA = indexA;
 	edge.IndexB = indexB;
 	s_SourceGraph.Edges.push_back(edge);
+	s_GraphGeneration++;
 
-    RegenerateGraph();
+	if (HasTimings(s_DrawGraph))
+	{
+		RegenerateGraph();
+		return;
+	}
+
+	const uint32_t edgeIndex = (uint32_t)s_DrawGraph.EdgeInstances.size();
+	s_DrawGraph.EdgeInstances.emplace_back(s_SourceGraph.Vertices[indexA].Position, s_SourceGraph.Vertices[indexB].Position);
+	s_DrawGraph.IncidentEdges[indexA].push_back(edgeIndex);
+	s_DrawGraph.IncidentEdges[indexB].push_back(edgeIndex);
+	s_DrawGraphEdits.Edges.push_back(edgeIndex);
+	ResetPlayback();
 }
 
 static void DeleteEdge(const int index)
@@ -603,6 +826,15 @@ static const char* AlgorithmTypeToString(const AlgorithmType type)
         case AlgorithmType::DEsopoPape:     return "D'Esopo-Pape";
         case AlgorithmType::BellmanFord:    return "Bellman-Ford";
         case AlgorithmType::FloydWarshall:  return "Floyd-Warshall";
+        case AlgorithmType::BidirectionalDijkstra: return "Dijkstra (Bidirectional)";
+        case AlgorithmType::AStar: return "A*";
+        case AlgorithmType::ALT: return "ALT (Landmarks)";
+        case AlgorithmType::ContractionHierarchies: return "Contraction Hierarchies";
+        case AlgorithmType::DijkstraIndexedHeap: return "Dijkstra (Indexed Heap)";
+        case AlgorithmType::DijkstraRadixHeap: return "Dijkstra (Radix Heap)";
+        case AlgorithmType::DeltaStepping: return "Delta-Stepping";
+        case AlgorithmType::DirectionOptimizingBFS: return "BFS (Direction-Optimizing)";
+        case AlgorithmType::Johnson: return "Johnson";
     }
 
     return "Unknown";
@@ -651,21 +883,53 @@ static GLuint CompileProgram(const char* vertex, const char* fragment)
     return program;
 }
 
-static GLuint CreateCircleShader()
+// Points the program's uniform block at its binding point, the block may be missing when the program doesn't use it
+static void BindUniformBlock(GLuint program, const char* name, GLuint binding)
 {
-    const char* vertex = R"(
-        #version 410 core
+    const GLuint index = glGetUniformBlockIndex(program, name);
+    if (index != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, index, binding);
+}
 
+// Declarations of the uniform blocks, the layouts must match ViewUniforms and AlgorithmUniforms
+static const char* ViewUniformsSource = R"(
+        layout(std140) uniform ViewUniforms
+        {
+            vec2 u_ViewportSize;
+            vec2 u_ViewportOffset;
+            float u_ViewportZoom;
+            float u_EdgeThickness;
+            float u_VertexRadius;
+            float u_Time;
+            int u_ShowTraversalPaths;
+            int u_ShowFinalPaths;
+        };
+)";
+
+static const char* AlgorithmUniformsSource = R"(
+        struct AlgorithmParameters
+        {
+            vec4 TraversalColor;
+            vec4 CompletedColor;
+            int Visible;
+            float Thickness;
+            float Duration;
+        };
+
+        layout(std140) uniform AlgorithmUniforms
+        {
+            AlgorithmParameters u_Algorithms[ALGORITHM_COUNT];
+        };
+)";
+
+static GLuint CreateCircleShader()
+{
+    const std::string vertex = std::string("#version 410 core\n") + ViewUniformsSource + R"(
         layout(location = 0) in vec2 a_Position;
         layout(location = 1) in vec2 a_InstancePos;
 
         layout(location = 0) out vec2 v_LocalPos;
 
-        uniform vec2 u_ViewportSize;
-        uniform vec2 u_ViewportOffset;
-        uniform float u_ViewportZoom;
-        uniform float u_VertexRadius;
-
         void main()
         {
             v_LocalPos = a_Position;
@@ -697,34 +961,36 @@ static GLuint CreateCircleShader()
         }
     )";
 
-    return CompileProgram(vertex, fragment);
+    const GLuint program = CompileProgram(vertex.c_str(), fragment);
+    BindUniformBlock(program, "ViewUniforms", ViewUniformsBinding);
+    return program;
 }
 
 static GLuint CreateLineShader()
 {
-    const char* vertex = R"(
-        #version 410 core
-
-        layout(location = 0) in vec2 a_Position;
-        layout(location = 1) in vec2 a_Normal;
-        layout(location = 2) in float a_TraversalTimes[7];
-        layout(location = 9) in float a_CompletionTimes[7];
+    // The algorithm count comes from AlgorithmType, the completion times start right after the packed traversal times
+    const std::string defines =
+        "#version 410 core\n"
+        "#define ALGORITHM_COUNT " + std::to_string(AlgorithmTypeCount) + "\n"
+        "#define ALGORITHM_SLOTS " + std::to_string(AlgorithmSlotCount) + "\n"
+        "#define COMPLETION_LOCATION " + std::to_string(2 + AlgorithmSlotCount) + "\n";
+
+    const std::string vertex = defines + ViewUniformsSource + AlgorithmUniformsSource + R"(
+        // Corner of the edge quad: x runs from endpoint A (0) to B (1), y is the side of the edge (+1 or -1)
+        layout(location = 0) in vec2 a_Corner;
+
+        // Per instance, the endpoints A and B
+        layout(location = 1) in vec4 a_Endpoints;
+        layout(location = 2) in vec4 a_TraversalTimes[ALGORITHM_SLOTS];
+        layout(location = COMPLETION_LOCATION) in vec4 a_CompletionTimes[ALGORITHM_SLOTS];
 
         layout(location = 0) out vec3 v_Color;
 
-        uniform vec2 u_ViewportSize;
-        uniform vec2 u_ViewportOffset;
-        uniform float u_ViewportZoom;
-        uniform float u_EdgeThickness;
-        uniform float u_Time;
-
-        uniform int u_ShowTraversalPaths;
-        uniform int u_ShowFinalPaths;
-
-        uniform vec4 u_TraversalColors[7];
-        uniform vec4 u_CompletedColors[7];
-        uniform int u_Visible[7];
-        uniform float u_Thicknesses[7];
+        // Undoes EncodeEdgeTime, negative when the edge was never reached
+        float DecodeEdgeTime(float encoded, float duration)
+        {
+            return encoded > 0.0 ? (encoded * 65535.0 - 1.0) / 65534.0 * duration : -1.0;
+        }
 
         void main()
         {
@@ -732,37 +998,47 @@ static GLuint CreateLineShader()
             float thickness_weight = 0.5;
             float count = 0.0;
             
-            for (int index = 0; index < 7; index++)
+            for (int index = 0; index < ALGORITHM_COUNT; index++)
             {
-                if (u_Visible[index] == 0)
+                AlgorithmParameters algorithm = u_Algorithms[index];
+                if (algorithm.Visible == 0)
                     continue;
+
+                float completion_time = DecodeEdgeTime(a_CompletionTimes[index / 4][index % 4], algorithm.Duration);
+                float traversal_time = DecodeEdgeTime(a_TraversalTimes[index / 4][index % 4], algorithm.Duration);
                 
-                bool in_complete = (u_ShowFinalPaths != 0) && (a_CompletionTimes[index] >= 0.0) && (u_Time >= a_CompletionTimes[index]);
-                bool in_traversed = (u_ShowTraversalPaths != 0) && (a_TraversalTimes[index] >= 0.0) && (u_Time >= a_TraversalTimes[index]);
+                bool in_complete = (u_ShowFinalPaths != 0) && (completion_time >= 0.0) && (u_Time >= completion_time);
+                bool in_traversed = (u_ShowTraversalPaths != 0) && (traversal_time >= 0.0) && (u_Time >= traversal_time);
                 float t;
 
-                float alpha = u_CompletedColors[index].a;
+                float alpha = algorithm.CompletedColor.a;
 
                 if (in_complete)
                 {
-                    colorSum += u_CompletedColors[index].xyz * alpha;
+                    colorSum += algorithm.CompletedColor.xyz * alpha;
                     t = 2.0;
                     count += alpha;
                 }
                 else if (in_traversed)
                 {
-                    colorSum += u_TraversalColors[index].xyz * alpha;
+                    colorSum += algorithm.TraversalColor.xyz * alpha;
                     t = 1.0;
                     count += alpha;
                 }
 
-                thickness_weight = max(thickness_weight, t * u_Thicknesses[index]);
+                thickness_weight = max(thickness_weight, t * algorithm.Thickness);
             }
 
             v_Color = count > 0 ? colorSum / count : vec3(0.5);
             float thickness = thickness_weight * u_EdgeThickness;
 
-            vec2 worldPos = a_Position * u_ViewportZoom + u_ViewportOffset + (a_Normal * thickness);
+            // Edges too short to have a direction collapse to nothing
+            vec2 to = a_Endpoints.zw - a_Endpoints.xy;
+            float edge_length = length(to);
+            vec2 normal = edge_length < 1e-4 ? vec2(0.0) : vec2(-to.y, to.x) / edge_length;
+
+            vec2 position = mix(a_Endpoints.xy, a_Endpoints.zw, a_Corner.x);
+            vec2 worldPos = position * u_ViewportZoom + u_ViewportOffset + (normal * a_Corner.y * thickness);
             vec2 ndc = (worldPos / u_ViewportSize) * 2.0 - 1.0;
             ndc.y = -ndc.y;
 
@@ -782,7 +1058,25 @@ static GLuint CreateLineShader()
         }
     )";
 
-    return CompileProgram(vertex, fragment);
+    const GLuint program = CompileProgram(vertex.c_str(), fragment);
+    BindUniformBlock(program, "ViewUniforms", ViewUniformsBinding);
+    BindUniformBlock(program, "AlgorithmUniforms", AlgorithmUniformsBinding);
+    return program;
+}
+
+static void CreateUniformBuffers()
+{
+    glGenBuffers(1, &view_ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, view_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(ViewUniforms), &s_ViewUniforms, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, ViewUniformsBinding, view_ubo);
+
+    glGenBuffers(1, &algorithm_ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, algorithm_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, AlgorithmTypeCount * sizeof(AlgorithmUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, AlgorithmUniformsBinding, algorithm_ubo);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
 static void CreateCircleGeometry()
@@ -827,27 +1121,46 @@ static void CreateCircleGeometry()
 
 static void CreateLineGeometry()
 {
+    // Two triangles spanning the edge from A to B, offset to either side along the normal in the shader
+    float corners[] =
+    {
+        0.0f,  1.0f,
+        0.0f, -1.0f,
+        1.0f,  1.0f,
+        1.0f,  1.0f,
+        0.0f, -1.0f,
+        1.0f, -1.0f
+    };
+
     glGenVertexArrays(1, &line_vao);
     glBindVertexArray(line_vao);
 
     glGenBuffers(1, &line_vbo);
     glBindBuffer(GL_ARRAY_BUFFER, line_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
 
-    glEnableVertexAttribArray(0); // a_Position
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(EdgeVertex), (void*)offsetof(EdgeVertex, Position));
+    glEnableVertexAttribArray(0); // a_Corner
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
 
-    glEnableVertexAttribArray(1); // a_Normal
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(EdgeVertex), (void*)offsetof(EdgeVertex, Normal));
+    // Instance buffer, one EdgeInstance per edge
+    glGenBuffers(1, &edge_instance_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, edge_instance_vbo);
 
-	for (int i = 0; i < AlgorithmTypeCount; i++)
+    glEnableVertexAttribArray(1); // a_Endpoints, A and B are adjacent
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(EdgeInstance), (void*)offsetof(EdgeInstance, A));
+    glVertexAttribDivisor(1, 1);
+
+	for (int i = 0; i < AlgorithmSlotCount; i++)
 	{
         // a_TraversalTimes[i]
 		glEnableVertexAttribArray(2 + i);
-		glVertexAttribPointer(2 + i, 1, GL_FLOAT, GL_FALSE, sizeof(EdgeVertex), (void*)(offsetof(EdgeVertex, TraversalTimes) + i * sizeof(float)));
+		glVertexAttribPointer(2 + i, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(EdgeInstance), (void*)(offsetof(EdgeInstance, TraversalTimes) + i * 4 * sizeof(EdgeTime)));
+		glVertexAttribDivisor(2 + i, 1);
 
         // a_CompletionTimes[i]
-		glEnableVertexAttribArray(2 + AlgorithmTypeCount + i);
-		glVertexAttribPointer(2 + AlgorithmTypeCount + i, 1, GL_FLOAT, GL_FALSE, sizeof(EdgeVertex), (void*)(offsetof(EdgeVertex, CompletionTimes) + i * sizeof(float)));
+		glEnableVertexAttribArray(2 + AlgorithmSlotCount + i);
+		glVertexAttribPointer(2 + AlgorithmSlotCount + i, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(EdgeInstance), (void*)(offsetof(EdgeInstance, CompletionTimes) + i * 4 * sizeof(EdgeTime)));
+		glVertexAttribDivisor(2 + AlgorithmSlotCount + i, 1);
 	}
 
     glBindVertexArray(0);
@@ -898,26 +1211,81 @@ static DrawGraph CreateTimedDrawGraph(uint32_t source, uint32_t destination, con
 static void UpdateDrawGraphGPUSide()
 {
 	// Update what the GPU data sees
-	glBindVertexArray(line_vao);
-	glBindBuffer(GL_ARRAY_BUFFER, line_vbo);
-	glBufferData(GL_ARRAY_BUFFER, s_DrawGraph.EdgeVertices.size() * sizeof(EdgeVertex), s_DrawGraph.EdgeVertices.data(), GL_DYNAMIC_DRAW);
-	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, edge_instance_vbo);
+	glBufferData(GL_ARRAY_BUFFER, s_DrawGraph.EdgeInstances.size() * sizeof(EdgeInstance), s_DrawGraph.EdgeInstances.data(), GL_DYNAMIC_DRAW);
+	s_EdgeBufferCapacity = s_DrawGraph.EdgeInstances.size();
 
 	glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
 	glBufferData(GL_ARRAY_BUFFER, s_DrawGraph.Vertices.size() * sizeof(VertexInstance), s_DrawGraph.Vertices.data(), GL_DYNAMIC_DRAW);
+	s_VertexBufferCapacity = s_DrawGraph.Vertices.size();
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// Everything is uploaded, including any patched records still waiting
+	s_DrawGraphEdits.Vertices.clear();
+	s_DrawGraphEdits.Edges.clear();
+
+	UpdateAlgorithmUniforms();
 }
 
-static void RegenerateGraph()
+// Uploads the records at the dirty indices in runs of consecutive indices. When records were appended past the buffer's
+// capacity it is reallocated at twice the size and uploaded whole, so appending stays amortized O(1).
+template <typename Record>
+static void UploadDirtyRecords(GLuint buffer, const std::vector<Record>& records, std::vector<uint32_t>& dirty, size_t& capacity)
 {
-	s_DrawGraph = CreateDrawGraph(s_SourceGraph);
-	UpdateDrawGraphGPUSide();
+	if (dirty.empty())
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+	if (records.size() > capacity)
+	{
+		capacity = std::max(records.size(), capacity * 2);
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Record), nullptr, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, records.size() * sizeof(Record), records.data());
+	}
+	else
+	{
+		std::sort(dirty.begin(), dirty.end());
+		dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+		for (size_t first = 0; first < dirty.size(); )
+		{
+			size_t last = first + 1;
+			while (last < dirty.size() && dirty[last] == dirty[last - 1] + 1)
+				last++;
+
+			glBufferSubData(GL_ARRAY_BUFFER, dirty[first] * sizeof(Record), (last - first) * sizeof(Record), &records[dirty[first]]);
+			first = last;
+		}
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	dirty.clear();
+}
+
+// Called once a frame before drawing, so a drag that moves a vertex every frame uploads only what it touched
+static void FlushDrawGraphEdits()
+{
+	UploadDirtyRecords(instance_vbo, s_DrawGraph.Vertices, s_DrawGraphEdits.Vertices, s_VertexBufferCapacity);
+	UploadDirtyRecords(edge_instance_vbo, s_DrawGraph.EdgeInstances, s_DrawGraphEdits.Edges, s_EdgeBufferCapacity);
+}
 
+static void ResetPlayback()
+{
     s_Time = 0.0f;
     s_GraceFrames = NumGraceFrames;
     s_Paused = true;
 }
 
+// Called after s_SourceGraph was edited or replaced
+static void RegenerateGraph()
+{
+	s_GraphGeneration++;
+	s_DrawGraph = CreateDrawGraph(s_SourceGraph);
+	UpdateDrawGraphGPUSide();
+	ResetPlayback();
+}
+
 static void RegenerateTimedGraph()
 {
     if (s_SourceGraph.Vertices.size() < 2 || s_SourceGraph.Edges.size() < 1)
@@ -968,42 +1336,20 @@ static void NewGraph()
 
 static bool LoadGraph(const char* filepath)
 {
-    if (!filepath || strlen(filepath) == 0)
-        return false;
-
-    if (!std::filesystem::exists(filepath))
-        return false;
-
-	YAML::Node config;
-	try
-	{
-		config = YAML::LoadFile(filepath);
-	}
-	catch (...)
-	{
-		std::cerr << "Failed to load graph visualizer file: " << filepath << std::endl;
+	GraphFile file;
+	if (!LoadGraphFile(filepath, file))
 		return false;
-	}
 
 	if (std::filesystem::exists(TEMP_FILE_NAME))
 		std::filesystem::remove(TEMP_FILE_NAME);
 
     const uint32_t offset = s_SourceGraph.Vertices.size();
 
-	for (const auto& node : config["nodes"])
-	{
-		const float x = node["x"].as<float>();
-		const float y = node["y"].as<float>();
-		s_SourceGraph.Vertices.push_back({ ImVec2(x, y) });
-	}
+	for (const auto& vertex : file.Vertices)
+		s_SourceGraph.Vertices.push_back({ ImVec2(vertex.X, vertex.Y) });
 
-	for (const auto& edge : config["edges"])
-	{
-        const auto nameNode = edge["name"];
-		const uint32_t source = edge["source"].as<uint32_t>();
-		const uint32_t target = edge["target"].as<uint32_t>();
-        s_SourceGraph.Edges.emplace_back(nameNode ? nameNode.as<std::string>() : std::string(), offset + source, offset + target);
-	}
+	for (auto& edge : file.Edges)
+        s_SourceGraph.Edges.emplace_back(edge.Name, offset + edge.Source, offset + edge.Target);
 
 	std::cout << "Loaded " << s_SourceGraph.Vertices.size() << " nodes and " << s_SourceGraph.Edges.size() << " edges\n";
 	return true;
@@ -1129,6 +1475,8 @@ static void Init()
     line_shader = CreateLineShader();
     CreateLineGeometry();
 
+    CreateUniformBuffers();
+
     s_AlgorithmVisible.fill(true);
     s_AlgorithmThickness.fill(1.0f);
     s_AlgorithmTrackMemory.fill(true);
@@ -1494,6 +1842,28 @@ static void LoadTextGraph(const std::string& text, float scale, bool connected)
 	}
 }
 
+// Uploads the view block when anything in it changed since the last frame
+static void UpdateViewUniforms()
+{
+    ViewUniforms uniforms;
+    uniforms.ViewportSize = viewport_size;
+    uniforms.ViewportOffset = viewport_offset;
+    uniforms.ViewportZoom = viewport_zoom;
+    uniforms.EdgeThickness = s_EdgeThickness;
+    uniforms.VertexRadius = s_VertexRadius;
+    uniforms.Time = s_Time;
+    uniforms.ShowTraversalPaths = s_ShowTraversalPaths;
+    uniforms.ShowFinalPaths = s_ShowFinalPaths;
+
+    if (uniforms == s_ViewUniforms)
+        return;
+
+    s_ViewUniforms = uniforms;
+    glBindBuffer(GL_UNIFORM_BUFFER, view_ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ViewUniforms), &uniforms);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
 static float GetPlaybackDuration()
 {
     return s_DrawGraph.Duration * (1.0f + PlaybackPaddingPercentage);
@@ -1539,38 +1909,19 @@ static void OnUpdate()
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    UpdateViewUniforms();
+    FlushDrawGraphEdits();
+
     auto& graph = s_DrawGraph;
-    auto& edge_vertices = graph.EdgeVertices;
+    auto& edge_instances = graph.EdgeInstances;
     auto& vertices = graph.Vertices;
 
     // Draw edges
-    if (!edge_vertices.empty() && !vertices.empty())
+    if (!edge_instances.empty() && !vertices.empty())
     {
         glUseProgram(line_shader);
-
-        GLint viewport_loc = glGetUniformLocation(line_shader, "u_ViewportSize");
-        glUniform2f(viewport_loc, viewport_size.x, viewport_size.y);
-
-        GLint offset_loc = glGetUniformLocation(line_shader, "u_ViewportOffset");
-        glUniform2f(offset_loc, viewport_offset.x, viewport_offset.y);
-
-        GLint zoom_loc = glGetUniformLocation(line_shader, "u_ViewportZoom");
-        glUniform1f(zoom_loc, viewport_zoom);
-
-        GLint thickness_loc = glGetUniformLocation(line_shader, "u_EdgeThickness");
-        glUniform1f(thickness_loc, s_EdgeThickness);
-
-        GLint time_loc = glGetUniformLocation(line_shader, "u_Time");
-        glUniform1f(time_loc, s_Time);
-
-		GLint show_traversal_paths_loc = glGetUniformLocation(line_shader, "u_ShowTraversalPaths");
-		glUniform1i(show_traversal_paths_loc, s_ShowTraversalPaths);
-
-		GLint show_final_paths_loc = glGetUniformLocation(line_shader, "u_ShowFinalPaths");
-		glUniform1i(show_final_paths_loc, s_ShowFinalPaths);
-
         glBindVertexArray(line_vao);
-        glDrawArrays(GL_TRIANGLES, 0, edge_vertices.size());
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, edge_instances.size());
         glBindVertexArray(0);
     }
 
@@ -1579,19 +1930,6 @@ static void OnUpdate()
     {
         glUseProgram(circle_shader);
 
-        // Set uniforms
-        GLint viewport_loc = glGetUniformLocation(circle_shader, "u_ViewportSize");
-        glUniform2f(viewport_loc, viewport_size.x, viewport_size.y);
-
-        GLint offset_loc = glGetUniformLocation(circle_shader, "u_ViewportOffset");
-        glUniform2f(offset_loc, viewport_offset.x, viewport_offset.y);
-
-        GLint zoom_loc = glGetUniformLocation(circle_shader, "u_ViewportZoom");
-        glUniform1f(zoom_loc, viewport_zoom);
-
-        GLint radius_loc = glGetUniformLocation(circle_shader, "u_VertexRadius");
-        glUniform1f(radius_loc, s_VertexRadius);
-
         // Draw
         glBindVertexArray(circle_vao);
         glDrawArraysInstanced(GL_TRIANGLES, 0, 6, vertices.size());
@@ -2105,6 +2443,54 @@ static bool SliderFloat(const char* label, float* v, float v_min, float v_max, c
 // Table Sorting logic
 static ImGuiTableSortSpecs* g_SortSpecs = nullptr;
 
+// Every counter of the measured runs, or why there are none
+static void DrawHardwareCountersTooltip(const DrawGraphAlgorithmMetadata& metadata)
+{
+    if (!ImGui::BeginItemTooltip())
+        return;
+
+    if (!metadata.Hardware.Any())
+    {
+        if (!s_TrackHardwareCounters)
+            ImGui::TextDisabled("Hardware counters are turned off in the settings");
+        else if (!GetHardwareCounterGroup().IsAvailable())
+            ImGui::TextDisabled(FA_TRIANGLE_EXCLAMATION " %s", GetHardwareCounterGroup().GetError().c_str());
+        else
+            ImGui::TextDisabled("The counters didn't run during the measurement");
+
+        ImGui::EndTooltip();
+        return;
+    }
+
+    if (metadata.Threads > 1)
+        ImGui::Text(FA_MICROCHIP " Per measured run, summed over all %u threads", metadata.Threads);
+    else
+        ImGui::Text(FA_MICROCHIP " Per measured run");
+
+    const double instructions = metadata.Hardware.Get(HardwareEvent::Instructions);
+    for (size_t index = 0; index < HardwareEventCount; index++)
+    {
+        const HardwareEvent event = (HardwareEvent)index;
+        if (!metadata.Hardware.Has(event))
+        {
+            ImGui::TextDisabled("%s: not supported", HardwareEventToString(event));
+            continue;
+        }
+
+        // Misses are easier to compare per thousand instructions (MPKI)
+        const bool miss = event != HardwareEvent::Cycles && event != HardwareEvent::Instructions;
+        if (miss && metadata.Hardware.Has(HardwareEvent::Instructions) && instructions > 0.0)
+            ImGui::Text("%s: %.0f (%.2f per 1k instructions)", HardwareEventToString(event), metadata.Hardware.Get(event), metadata.Hardware.Get(event) * 1000.0 / instructions);
+        else
+            ImGui::Text("%s: %.0f", HardwareEventToString(event), metadata.Hardware.Get(event));
+    }
+
+    if (metadata.Hardware.GetIPC() > 0.0)
+        ImGui::Text("IPC: %.2f", metadata.Hardware.GetIPC());
+
+    ImGui::EndTooltip();
+}
+
 static int CompareAlgorithms(const void* lhs, const void* rhs)
 {
 	const int index1 = *(const int*)lhs;
@@ -2120,10 +2506,19 @@ static int CompareAlgorithms(const void* lhs, const void* rhs)
 	switch (spec->ColumnIndex)
 	{
 	case 0: delta = (float)(index1 - index2); break;
-	case 1: delta = (a.Duration - b.Duration); break;
+	case 1: delta = (GetDisplayedDuration(a) - GetDisplayedDuration(b)); break;
 	case 2: delta = (a.TotalDistance - b.TotalDistance); break;
 	case 3: delta = (a.PeakMemoryUsage - b.PeakMemoryUsage); break;
 	case 4: delta = (a.GraphTraversalPercentage - b.GraphTraversalPercentage); break;
+	case 5: delta = ((float)a.Counters.Settled - (float)b.Counters.Settled); break;
+	case 6: delta = ((float)a.Counters.Relaxations - (float)b.Counters.Relaxations); break;
+	case 7: delta = ((float)a.Counters.SuccessfulRelaxations - (float)b.Counters.SuccessfulRelaxations); break;
+	case 8: delta = ((float)a.Counters.QueuePushes - (float)b.Counters.QueuePushes); break;
+	case 9: delta = ((float)a.Counters.QueuePops - (float)b.Counters.QueuePops); break;
+	case 10: delta = ((float)a.Counters.Reinsertions - (float)b.Counters.Reinsertions); break;
+	case 11: delta = ((float)a.Counters.PeakQueueSize - (float)b.Counters.PeakQueueSize); break;
+	case 12: delta = (float)(a.Hardware.GetIPC() - b.Hardware.GetIPC()); break;
+	case 13: delta = (float)(a.Hardware.Get(HardwareEvent::LLCMisses) - b.Hardware.Get(HardwareEvent::LLCMisses)); break;
 	}
 
 	if (delta < 0) return spec->SortDirection == ImGuiSortDirection_Ascending ? -1 : +1;
@@ -2205,6 +2600,25 @@ static void OnImGuiRender()
             if (s_TrackMemory)
                 ImGui::DragFloat(FA_STOPWATCH " Tracking Interval", &s_MemoryTrackingInterval, 1.0f, 0.1f, 50.0f, "%.3f ms");
 
+            ImGui::Checkbox(FA_MICROCHIP " Hardware Counters", &s_TrackHardwareCounters);
+            if (s_TrackHardwareCounters && !GetHardwareCounterGroup().IsAvailable())
+                ImGui::SetItemTooltip(FA_TRIANGLE_EXCLAMATION " %s", GetHardwareCounterGroup().GetError().c_str());
+            else
+                ImGui::SetItemTooltip("Count cycles, instructions, cache, branch and TLB misses of the measured runs with perf_event");
+
+            ImGui::Separator();
+
+            int timingDisplay = (int)s_TimingDisplay;
+            if (ImGui::Combo(FA_TIMER " Execution Time", &timingDisplay, s_TimingDisplayNames, IM_ARRAYSIZE(s_TimingDisplayNames)))
+            {
+                s_TimingDisplay = (TimingDisplay)timingDisplay;
+                if (g_SortSpecs)
+                    g_SortSpecs->SpecsDirty = true;
+            }
+
+            ImGui::DragInt(FA_FIRE " Warm-up Runs", &s_TimingWarmupRuns, 0.1f, 0, 100);
+            ImGui::DragInt(FA_REPEAT " Repetitions", &s_TimingRepetitions, 0.1f, 1, 1000);
+
             ImGui::EndMenu();
         }
 
@@ -2461,9 +2875,7 @@ static void OnImGuiRender()
             }
 			else if (select_down && s_DragContext.Type == DragType::Vertex && s_DragContext.Index >= 0 && s_DragContext.Index < s_SourceGraph.Vertices.size())
 			{
-				const ImVec2 world = ScreenToWorld(current_pos, image_position);
-				s_SourceGraph.Vertices[s_DragContext.Index].Position = world;
-				RegenerateGraph();
+				MoveVertex(s_DragContext.Index, ScreenToWorld(current_pos, image_position));
 			}
         }
         else
@@ -2925,14 +3337,23 @@ static void OnImGuiRender()
 
     bool any_valid = false;
 
-	if (ImGui::BeginTable("##StatisticsTable", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Sortable))
+	if (ImGui::BeginTable("##StatisticsTable", 14, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Sortable | ImGuiTableFlags_Hideable))
     {
-		// Column headers
+		// Column headers, the operation counters come from the recorded run and can be hidden from the header's context menu
 		ImGui::TableSetupColumn(FA_DIAGRAM_PROJECT " Algorithm");
 		ImGui::TableSetupColumn(FA_TIMER " Execution Time");
 		ImGui::TableSetupColumn(FA_RULER " Distance");
 		ImGui::TableSetupColumn(FA_MEMORY " Peak Memory Usage");
 		ImGui::TableSetupColumn(FA_CODE_BRANCH " Graph Traversed");
+		ImGui::TableSetupColumn(FA_CIRCLE_CHECK " Settled");
+		ImGui::TableSetupColumn(FA_ARROWS_ROTATE " Relaxations");
+		ImGui::TableSetupColumn(FA_CHECK_DOUBLE " Successful");
+		ImGui::TableSetupColumn(FA_RIGHT_TO_BRACKET " Pushes");
+		ImGui::TableSetupColumn(FA_RIGHT_FROM_BRACKET " Pops");
+		ImGui::TableSetupColumn(FA_REPEAT " Reinsertions");
+		ImGui::TableSetupColumn(FA_LAYER_GROUP " Peak Queue");
+		ImGui::TableSetupColumn(FA_MICROCHIP " IPC");
+		ImGui::TableSetupColumn(FA_MICROCHIP " LLC Misses");
 		ImGui::TableHeadersRow();
 
 		if (ImGuiTableSortSpecs* sort_specs = ImGui::TableGetSortSpecs())
@@ -2959,17 +3380,124 @@ static void OnImGuiRender()
 			ImGui::TableSetColumnIndex(0);
 			ImGui::Text("%s", AlgorithmTypeToString((AlgorithmType)index));
 
+            if (metadata.Threads > 1)
+            {
+                ImGui::SameLine();
+                ImGui::TextDisabled(FA_MICROCHIP " %u", metadata.Threads);
+
+                const auto& baseline = s_DrawGraph.Metadata[(size_t)AlgorithmType::DijkstraQueue];
+                if (baseline.Valid && metadata.Duration > 0.0f)
+                    ImGui::SetItemTooltip(FA_MICROCHIP " Split across %u threads, %.2fx the speed of %s", metadata.Threads, baseline.Duration / metadata.Duration, AlgorithmTypeToString(AlgorithmType::DijkstraQueue));
+                else
+                    ImGui::SetItemTooltip(FA_MICROCHIP " Split across %u threads, enable %s to see the speedup", metadata.Threads, AlgorithmTypeToString(AlgorithmType::DijkstraQueue));
+            }
+
+            // The two all-pairs algorithms fill the same table, so each is measured against the other
+            const AlgorithmType allPairsCounterpart = GetAllPairsCounterpart((AlgorithmType)index);
+            if (allPairsCounterpart != AlgorithmType::Count && s_DrawGraph.Metadata[(size_t)allPairsCounterpart].Valid)
+            {
+                const auto& other = s_DrawGraph.Metadata[(size_t)allPairsCounterpart];
+
+                ImGui::SameLine();
+                ImGui::TextDisabled(FA_SCALE_BALANCED);
+                if (ImGui::BeginItemTooltip())
+                {
+                    ImGui::Text(FA_SCALE_BALANCED " All pairs on %zu vertices against %s", s_SourceGraph.Vertices.size(), AlgorithmTypeToString(allPairsCounterpart));
+                    const float duration = GetDisplayedDuration(metadata);
+                    const float otherDuration = GetDisplayedDuration(other);
+                    ImGui::Text("Time: %.3f ms vs %.3f ms, %.2fx the speed", duration / 1'000'000.0f, otherDuration / 1'000'000.0f,
+                        duration > 0.0f ? otherDuration / duration : 0.0f);
+
+                    if (!metadata.MemoryTrackingData.empty() && !other.MemoryTrackingData.empty())
+                        ImGui::Text("Peak memory: %zu KiB vs %zu KiB", metadata.PeakMemoryUsage / 1024, other.PeakMemoryUsage / 1024);
+                    else
+                        ImGui::TextDisabled("Track the memory of both to compare their peak usage");
+
+                    ImGui::EndTooltip();
+                }
+            }
+
 			ImGui::TableSetColumnIndex(1);
-			ImGui::Text("%.0f ms", metadata.Duration / 1'000'000.0f);
+			ImGui::Text("%.3f ms", GetDisplayedDuration(metadata) / 1'000'000.0f);
+            ImGui::SetItemTooltip(
+                "Min: %.3f ms\nMedian: %.3f ms\nP95: %.3f ms\nStd. Dev: %.3f ms\nSingle Shot: %.3f ms\n"
+                "Over %zu runs, %.3f ms with traversal logging",
+                metadata.Timing.Min / 1'000'000.0, metadata.Timing.Median / 1'000'000.0, metadata.Timing.P95 / 1'000'000.0,
+                metadata.Timing.StdDev / 1'000'000.0, metadata.SingleShotDuration / 1'000'000.0f,
+                metadata.Timing.Samples, metadata.RecordedDuration / 1'000'000.0f);
 
 			ImGui::TableSetColumnIndex(2);
 			ImGui::Text("%.0f units", metadata.TotalDistance);
+            if (metadata.SearchDistance >= 0.0f)
+            {
+                const float error = metadata.SearchDistance - metadata.TotalDistance;
+                ImGui::SetItemTooltip(FA_RULER " Quantized length %.3f units, %+.4f units (%+.4f%%) from the exact length of the same path",
+                    metadata.SearchDistance, error, metadata.TotalDistance > 0.0f ? error / metadata.TotalDistance * 100.0f : 0.0f);
+            }
 
 			ImGui::TableSetColumnIndex(3);
             metadata.MemoryTrackingData.empty() ? ImGui::TextDisabled(" " FA_DASH " ") : ImGui::Text("%zu KiB", metadata.PeakMemoryUsage / 1024);
+            ImGui::SetItemTooltip(FA_MEMORY " Allocated by this query, workspaces kept from an earlier query on a graph as large are reused");
 
 			ImGui::TableSetColumnIndex(4);
 			ImGui::Text("%.0f%%", metadata.GraphTraversalPercentage * 100.0f);
+
+            // Counters the algorithm has no use for (no queue, no settling) stay at zero and show as a dash
+            const size_t counters[] = {
+                metadata.Counters.Settled, metadata.Counters.Relaxations, metadata.Counters.SuccessfulRelaxations,
+                metadata.Counters.QueuePushes, metadata.Counters.QueuePops, metadata.Counters.Reinsertions, metadata.Counters.PeakQueueSize
+            };
+            for (int column = 0; column < IM_ARRAYSIZE(counters); column++)
+            {
+                ImGui::TableSetColumnIndex(5 + column);
+                counters[column] == 0 ? ImGui::TextDisabled(" " FA_DASH " ") : ImGui::Text("%zu", counters[column]);
+            }
+
+            ImGui::TableSetColumnIndex(12);
+            metadata.Hardware.Has(HardwareEvent::Cycles) && metadata.Hardware.Has(HardwareEvent::Instructions)
+                ? ImGui::Text("%.2f", metadata.Hardware.GetIPC()) : ImGui::TextDisabled(" " FA_DASH " ");
+            DrawHardwareCountersTooltip(metadata);
+
+            ImGui::TableSetColumnIndex(13);
+            metadata.Hardware.Has(HardwareEvent::LLCMisses)
+                ? ImGui::Text("%.0f", metadata.Hardware.Get(HardwareEvent::LLCMisses)) : ImGui::TextDisabled(" " FA_DASH " ");
+            DrawHardwareCountersTooltip(metadata);
+
+            // Preprocessing gets its own row under the algorithm, it is shared by every query on the same graph
+            if (metadata.Preprocessed)
+            {
+                ImGui::TableNextRow();
+
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextDisabled("  " FA_GEARS " Preprocessing");
+
+                ImGui::TableSetColumnIndex(1);
+                if (metadata.PreprocessingReused)
+                {
+                    ImGui::TextDisabled("Reused");
+                    ImGui::SetItemTooltip("Built in %.3f ms by an earlier query on this graph", metadata.PreprocessingDuration / 1'000'000.0f);
+                }
+                else
+                {
+                    ImGui::TextDisabled("%.3f ms", metadata.PreprocessingDuration / 1'000'000.0f);
+                }
+
+                ImGui::TableSetColumnIndex(2);
+                ImGui::TextDisabled(" " FA_DASH " ");
+
+                ImGui::TableSetColumnIndex(3);
+                ImGui::TextDisabled("%zu KiB", metadata.PreprocessedBytes / 1024);
+                ImGui::SetItemTooltip(FA_MEMORY " Memory kept for the queries, not included in the peak above");
+
+                ImGui::TableSetColumnIndex(4);
+                ImGui::TextDisabled(" " FA_DASH " ");
+
+                for (int column = 5; column < 14; column++)
+                {
+                    ImGui::TableSetColumnIndex(column);
+                    ImGui::TextDisabled(" " FA_DASH " ");
+                }
+            }
 		}
 
 		ImGui::EndTable();
@@ -3025,15 +3553,17 @@ static void OnImGuiRender()
     ImGui::End();
 }
 
-static AdjacencyMatrix BuildAdjacencyMatrix(const SourceGraph& graph)
-{
-	const size_t N = graph.Vertices.size();
+// Kept between route queries and rebuilt only when the graph changed, so its Id still matches what the algorithms preprocessed
+static CSRGraph s_CSRGraph;
+static uint64_t s_CSRGraphGeneration = 0;
 
-	// Initialize N�N matrix with {0.0f, -1} meaning "no edge"
-	AdjacencyMatrix matrix(N, std::vector<std::pair<float, int>>(N, { 0.0f, -1 }));
+// Duration of each algorithm's last preprocessing, shown again when a later query reuses it
+static std::array<float, AlgorithmTypeCount> s_PreprocessingDurations = {};
 
-	// Populate matrix with edges
-	for (uint32_t index = 0; index < graph.Edges.size(); index++)
+static CSRGraph BuildCSRGraph(const SourceGraph& graph)
+{
+	// Only real edges are stored, so this is O(V + E) rather than a dense N*N matrix
+	CSRGraph csrGraph = CSRGraph::FromEdges((int)graph.Vertices.size(), graph.Edges.size(), [&graph](size_t index)
 	{
 		const auto& e = graph.Edges[index];
 
@@ -3041,11 +3571,15 @@ static AdjacencyMatrix BuildAdjacencyMatrix(const SourceGraph& graph)
         const auto& vertexB = graph.Vertices[e.IndexB];
 
         const float weight = Distance(vertexA.Position, vertexB.Position);
-		matrix[e.IndexA][e.IndexB] = { weight, index };
-		matrix[e.IndexB][e.IndexA] = { weight, index };
-	}
+		return CSREdge{ (int)e.IndexA, (int)e.IndexB, weight };
+	});
 
-	return matrix;
+    // Weights are Euclidean, so the positions give the goal directed algorithms an admissible heuristic
+    csrGraph.Positions.reserve(graph.Vertices.size());
+    for (const auto& vertex : graph.Vertices)
+        csrGraph.Positions.push_back({ vertex.Position.x, vertex.Position.y });
+
+    return csrGraph;
 }
 
 static DrawGraph CreateDrawGraph(const SourceGraph& graph)
@@ -3053,27 +3587,15 @@ static DrawGraph CreateDrawGraph(const SourceGraph& graph)
     DrawGraph drawGraph;
 	drawGraph.Vertices = graph.Vertices;
 
-	for (const auto& edge : graph.Edges)
+	// Every edge gets an instance, even degenerate ones (the shader collapses those), so instances and edges share indices
+	drawGraph.EdgeInstances.reserve(graph.Edges.size());
+	drawGraph.IncidentEdges.resize(graph.Vertices.size());
+	for (uint32_t index = 0; index < graph.Edges.size(); index++)
 	{
-		const auto& A = graph.Vertices[edge.IndexA].Position;
-		const auto& B = graph.Vertices[edge.IndexB].Position;
-
-		const ImVec2 to = B - A;
-		const float length = sqrtf(to.x * to.x + to.y * to.y);
-		if (length < 1e-4f)
-			continue;
-
-		const ImVec2 direction = to / length;
-		const ImVec2 normal = { -direction.y, direction.x };
-
-		// push two triangles
-		drawGraph.EdgeVertices.emplace_back(A,  normal);
-		drawGraph.EdgeVertices.emplace_back(A, -normal);
-		drawGraph.EdgeVertices.emplace_back(B, normal);
-
-		drawGraph.EdgeVertices.emplace_back(B,  normal);
-		drawGraph.EdgeVertices.emplace_back(A, -normal);
-		drawGraph.EdgeVertices.emplace_back(B, -normal);
+		const auto& edge = graph.Edges[index];
+		drawGraph.EdgeInstances.emplace_back(graph.Vertices[edge.IndexA].Position, graph.Vertices[edge.IndexB].Position);
+		drawGraph.IncidentEdges[edge.IndexA].push_back(index);
+		drawGraph.IncidentEdges[edge.IndexB].push_back(index);
 	}
 
     // Default duration (just so it's not zero)
@@ -3082,39 +3604,81 @@ static DrawGraph CreateDrawGraph(const SourceGraph& graph)
     return drawGraph;
 }
 
-static void AddTimedDrawGraphEntry(const AlgorithmType algorithmType, Algorithm* algorithm, const SourceGraph& graph, DrawGraph& drawGraph, const AdjacencyMatrix& adjacencyMatrix, uint32_t source, uint32_t destination)
+static void AddTimedDrawGraphEntry(const AlgorithmType algorithmType, Algorithm* algorithm, const SourceGraph& graph, DrawGraph& drawGraph, const CSRGraph& csrGraph, uint32_t source, uint32_t destination)
 {
     if (!s_AlgorithmEnabled[(size_t)algorithmType])
         return;
 
+    // Query independent preprocessing is timed on its own so the query times stay comparable with the other algorithms,
+    // and only redone when the graph changed since the algorithm last preprocessed it
+    const bool preprocessingReused = algorithm->HasPreprocessing() && algorithm->IsPreprocessedFor(csrGraph);
+    if (algorithm->HasPreprocessing() && !preprocessingReused)
+    {
+        const auto preprocessStart = std::chrono::high_resolution_clock::now();
+        algorithm->Preprocess(csrGraph);
+        const auto preprocessEnd = std::chrono::high_resolution_clock::now();
+
+        s_PreprocessingDurations[(size_t)algorithmType] = std::chrono::duration<double, std::nano>(preprocessEnd - preprocessStart).count();
+    }
+
     const bool tracking = s_TrackMemory && s_AlgorithmTrackMemory[(size_t)algorithmType];
     if (tracking)
         START_MEMORY_TRACKING(s_MemoryTrackingInterval);
 
 	const auto start = std::chrono::high_resolution_clock::now();
-	algorithm->FindPath(adjacencyMatrix, source, destination);
+	algorithm->FindPath(csrGraph, source, destination);
 	const auto end = std::chrono::high_resolution_clock::now();
 
-    std::vector<size_t> memory = tracking ? END_MEMORY_TRACKING() : std::vector<size_t>{};
+    MemoryTrackingResult memory = tracking ? END_MEMORY_TRACKING() : MemoryTrackingResult{};
+
+    // A single cold run is too noisy to compare algorithms on small graphs, so warm the caches up and time repeated runs
+    for (int run = 0; run < s_TimingWarmupRuns; run++)
+        algorithm->FindPath(csrGraph, source, destination);
+
+    // The hardware counters cover all the measured runs and are averaged over them
+    const bool countHardware = s_TrackHardwareCounters && GetHardwareCounterGroup().IsAvailable();
+    if (countHardware)
+        GetHardwareCounterGroup().Start();
+
+    std::vector<double> samples;
+    samples.reserve(s_TimingRepetitions);
+    for (int run = 0; run < s_TimingRepetitions; run++)
+    {
+        const auto runStart = std::chrono::high_resolution_clock::now();
+        algorithm->FindPath(csrGraph, source, destination);
+        const auto runEnd = std::chrono::high_resolution_clock::now();
+
+        samples.push_back(std::chrono::duration<double, std::nano>(runEnd - runStart).count());
+    }
+
+    const HardwareCounters hardware = countHardware ? GetHardwareCounterGroup().Stop(s_TimingRepetitions) : HardwareCounters{};
+
+    const TimingStatistics timing = ComputeTimingStatistics(std::move(samples));
+
+    // Repeat the search with the traversal log enabled for playback, outside of the measured region
+	const auto recordStart = std::chrono::high_resolution_clock::now();
+	algorithm->RecordPath(csrGraph, source, destination);
+	const auto recordEnd = std::chrono::high_resolution_clock::now();
 
 	TraversalResult result = algorithm->GetResult();
 
-	const double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
-	const double totalSteps = result.TraversedEdges.size();
+	const double singleShotElapsed = std::chrono::duration<double, std::nano>(end - start).count();
+	const double elapsed = timing.Samples > 0 ? timing.Median : singleShotElapsed;
+	const double recordedElapsed = std::chrono::duration<double, std::nano>(recordEnd - recordStart).count();
+	const double totalSteps = (double)result.TraversedEdges.GetStepCount();
 
-	for (size_t step = 0; step < result.TraversedEdges.size(); step++)
+	// An edge shows up from the step that first touched it, so only the first touches are decoded, one per edge
+	auto& instances = drawGraph.EdgeInstances;
+	result.TraversedEdges.ForEachFirstTouch([&](const int edgeIndex, const size_t step)
 	{
-		const uint32_t edgeIndex = result.TraversedEdges[step];
-		const double traversalTime = ((double)step / totalSteps) * elapsed;
-
-		for (uint32_t vertex = 0; vertex < 6; vertex++)
-			drawGraph.EdgeVertices[edgeIndex * 6 + vertex].TraversalTimes[(size_t)algorithmType] = traversalTime;
-	}
+		if ((size_t)edgeIndex < instances.size())
+			instances[edgeIndex].TraversalTimes[(size_t)algorithmType] = EncodeEdgeTime((double)step / totalSteps);
+	});
 
 	for (const auto edgeIndex : result.FinalEdges)
 	{
-		for (uint32_t vertex = 0; vertex < 6; vertex++)
-			drawGraph.EdgeVertices[edgeIndex * 6 + vertex].CompletionTimes[(size_t)algorithmType] = elapsed;
+		if ((size_t)edgeIndex < instances.size())
+			instances[edgeIndex].CompletionTimes[(size_t)algorithmType] = EncodeEdgeTime(1.0);
 	}
 
     if (elapsed > drawGraph.Duration)
@@ -3123,11 +3687,22 @@ static void AddTimedDrawGraphEntry(const AlgorithmType algorithmType, Algorithm*
     auto& metadata = drawGraph.Metadata[(size_t)algorithmType];
     metadata.Valid = true;
     metadata.Duration = elapsed;
+    metadata.SingleShotDuration = singleShotElapsed;
+    metadata.RecordedDuration = recordedElapsed;
+    metadata.Timing = timing;
+    metadata.Preprocessed = algorithm->HasPreprocessing();
+    metadata.PreprocessingDuration = metadata.Preprocessed ? s_PreprocessingDurations[(size_t)algorithmType] : 0.0f;
+    metadata.PreprocessingReused = preprocessingReused;
+    metadata.PreprocessedBytes = algorithm->GetPreprocessedBytes();
 
-    std::unordered_set<uint32_t> uniqueEdges(result.TraversedEdges.begin(), result.TraversedEdges.end());
-    metadata.GraphTraversalPercentage = static_cast<double>(uniqueEdges.size()) / static_cast<double>(s_SourceGraph.Edges.size());
+    metadata.GraphTraversalPercentage = static_cast<double>(result.TraversedEdges.GetEdgeCount()) / static_cast<double>(s_SourceGraph.Edges.size());
 
-    metadata.PeakMemoryUsage = memory.empty() ? 0 : memory.back();
+    metadata.PeakMemoryUsage = memory.peak;
+
+    metadata.Counters = result.Counters;
+    metadata.Hardware = hardware;
+    metadata.Threads = algorithm->GetThreadCount();
+    metadata.SearchDistance = result.SearchDistance;
 
     metadata.TotalDistance = 0.0f;
 	for (const auto edgeIndex : result.FinalEdges)
@@ -3142,19 +3717,26 @@ static void AddTimedDrawGraphEntry(const AlgorithmType algorithmType, Algorithm*
 		metadata.TotalDistance += edgeLength;
 	}
 
-    metadata.MemoryTrackingData = std::move(memory);
+    metadata.MemoryTrackingData = std::move(memory.samples);
 }
 
+// The instances live as long as the program, so their search workspaces carry over from one route query to the next
 #define TIME_ALGORITHM(name)                        \
-    name name##_algorithm;                                 \
-    AddTimedDrawGraphEntry(AlgorithmType::name, &name##_algorithm, graph, drawGraph, adjacencyMatrix, source, destination);
+    static name name##_algorithm;                          \
+    AddTimedDrawGraphEntry(AlgorithmType::name, &name##_algorithm, graph, drawGraph, csrGraph, source, destination);
 
 static DrawGraph CreateTimedDrawGraph(uint32_t source, uint32_t destination, const SourceGraph& graph)
 {
     DrawGraph drawGraph = CreateDrawGraph(graph);
     drawGraph.Duration = 0.0f;
 
-    const AdjacencyMatrix adjacencyMatrix = BuildAdjacencyMatrix(graph);
+    if (s_CSRGraphGeneration != s_GraphGeneration)
+    {
+        s_CSRGraph = BuildCSRGraph(graph);
+        s_CSRGraphGeneration = s_GraphGeneration;
+    }
+
+    const CSRGraph& csrGraph = s_CSRGraph;
 
     TIME_ALGORITHM(BFS);
     TIME_ALGORITHM(DFS);
@@ -3163,6 +3745,15 @@ static DrawGraph CreateTimedDrawGraph(uint32_t source, uint32_t destination, con
     TIME_ALGORITHM(DEsopoPape);
     TIME_ALGORITHM(BellmanFord);
     TIME_ALGORITHM(FloydWarshall);
+    TIME_ALGORITHM(BidirectionalDijkstra);
+    TIME_ALGORITHM(AStar);
+    TIME_ALGORITHM(ALT);
+    TIME_ALGORITHM(ContractionHierarchies);
+    TIME_ALGORITHM(DijkstraIndexedHeap);
+    TIME_ALGORITHM(DijkstraRadixHeap);
+    TIME_ALGORITHM(DeltaStepping);
+    TIME_ALGORITHM(DirectionOptimizingBFS);
+    TIME_ALGORITHM(Johnson);
     
     return drawGraph;
 }
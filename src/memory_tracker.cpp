@@ -1,5 +1,6 @@
 #include "memory_tracker.hpp"
 #include <cstdlib>
+#include <new>
 #include <iostream>
 
 #define STB_TRUETYPE_IMPLEMENTATION
@@ -9,22 +10,55 @@
 #include "../vendor/stb_image/stb_image.h"
 
 MemoryTracker g_MemoryTracker;
-std::atomic<size_t> MemoryTracker::total_allocated{ 0 };
 
+// Placed in front of every block, a multiple of the strictest fundamental alignment so the block stays aligned
+struct alignas(alignof(std::max_align_t)) AllocationHeader {
+	std::size_t size;
+	uint64_t generation;
+};
+
+// Outside of a tracked run the only extra work is the thread local check, such blocks carry generation 0
 void* operator new(std::size_t sz) {
-	MemoryTracker::total_allocated += sz;
-	g_MemoryTracker.cumulative_allocated += sz;
-	g_MemoryTracker.record();
-	void* ptr = std::malloc(sz);
-	if (!ptr) throw std::bad_alloc();
-	return ptr;
+	MemoryTracker* tracker = t_MemoryTracking.tracker;
+	const uint64_t generation = tracker ? tracker->allocation_generation() : 0;
+
+	AllocationHeader* header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + sz));
+	if (!header) throw std::bad_alloc();
+
+	header->size = sz;
+	header->generation = generation;
+
+	if (tracker)
+		tracker->allocated(sz);
+
+	return header + 1;
 }
 
-void operator delete(void* ptr, std::size_t sz) noexcept {
-	MemoryTracker::total_allocated -= sz;
-	g_MemoryTracker.record();
-	std::free(ptr);
+void operator delete(void* ptr) noexcept {
+	if (!ptr) return;
+
+	AllocationHeader* header = static_cast<AllocationHeader*>(ptr) - 1;
+	if (header->generation != 0)
+		g_MemoryTracker.freed(header->size, header->generation);
+
+	std::free(header);
 }
 
 void* operator new[](std::size_t sz) { return operator new(sz); }
-void operator delete[](void* ptr, std::size_t sz) noexcept { operator delete(ptr, sz); }
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+
+// The header knows the size, so the sized forms are the same as the unsized ones
+void operator delete(void* ptr, std::size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { operator delete(ptr); }
+
+// Replaced as well so no block with a header can reach a library version that frees it without one
+void* operator new(std::size_t sz, const std::nothrow_t&) noexcept {
+	try { return operator new(sz); }
+	catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t sz, const std::nothrow_t&) noexcept {
+	try { return operator new(sz); }
+	catch (...) { return nullptr; }
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
@@ -1,72 +1,184 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
+#include <new>
 #include <vector>
+#include <array>
 #include <atomic>
-#include <mutex>
 #include <chrono>
 
+// Live heap bytes of one tracked run: the samples over time (starting at 0, ending with what was still live at the end)
+// and the high-water mark, which the samples can miss between two sampling points
+struct MemoryTrackingResult {
+	std::vector<size_t> samples;
+	size_t peak = 0;
+};
+
+// Lock-free single producer, single consumer ring of fixed capacity (a power of two). Pushing never allocates, so it is
+// safe from inside operator new, and a full ring drops the new value instead of blocking the producer.
+template <typename T, size_t Capacity>
+class SpscRing {
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	bool push(const T& value) {
+		const size_t tail = write_index.load(std::memory_order_relaxed);
+		if (tail - read_index.load(std::memory_order_acquire) == Capacity) return false;
+
+		slots[tail & (Capacity - 1)] = value;
+		write_index.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(T& value) {
+		const size_t head = read_index.load(std::memory_order_relaxed);
+		if (head == write_index.load(std::memory_order_acquire)) return false;
+
+		value = slots[head & (Capacity - 1)];
+		read_index.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	std::array<T, Capacity> slots{};
+	alignas(64) std::atomic<size_t> write_index{ 0 };
+	alignas(64) std::atomic<size_t> read_index{ 0 };
+};
+
+class MemoryTracker;
+
+// What the new/delete overloads need to know about the calling thread: the tracker its allocations count towards, null
+// outside of a tracked run so untracked allocations only pay for this one thread local check, and whether it is the
+// thread that started the run and takes the samples
+struct MemoryTrackingThreadState {
+	MemoryTracker* tracker = nullptr;
+	bool sampler = false;
+};
+
+inline thread_local MemoryTrackingThreadState t_MemoryTracking;
+
 class MemoryTracker {
 public:
-	// Start tracking memory
+	// Start tracking memory of the calling thread, and of worker threads that run its tasks (MemoryTrackingWorkerScope)
 	// sample_interval_ms = interval in milliseconds (can be fractional)
 	void begin(float sample_interval_ms = 10.0f) { // default 10ms
-		running = false;
-		samples.clear();
-		samples.push_back(0);
+		MemoryTrackingResult discarded;
+		drain(discarded.samples);
+
 		interval_ms = sample_interval_ms;
 		start_time = std::chrono::steady_clock::now();
 		last_sample_time = start_time;
-		cumulative_allocated = 0;
-		running = true;
+		live_bytes.store(0, std::memory_order_relaxed);
+		peak_bytes.store(0, std::memory_order_relaxed);
+		generation.fetch_add(1, std::memory_order_relaxed);
+
+		samples.push(0);
+		t_MemoryTracking = { this, true };
 	}
 
-	// Stop tracking and return the memory usage samples
-	std::vector<size_t> end() {
-		running = false;
+	// Stop tracking and return the live bytes over time and their peak
+	MemoryTrackingResult end() {
+		t_MemoryTracking = {};
 
-		{
-			std::lock_guard<std::mutex> guard(mutex);
-			samples.push_back(cumulative_allocated);
-		}
+		MemoryTrackingResult result;
+		drain(result.samples);
+		result.samples.push_back(live());
+		result.peak = peak_bytes.load(std::memory_order_relaxed);
+		return result;
+	}
 
-		return samples;
+	// Generation to stamp a new allocation with, only called for threads in a tracked run
+	uint64_t allocation_generation() const {
+		return generation.load(std::memory_order_relaxed);
 	}
 
-	// Called internally by overloaded new/delete
+	// Called by the new/delete overloads for allocations stamped with a generation. Only frees of the current
+	// generation count, memory that was already allocated when tracking started doesn't lower the live bytes.
+	void allocated(size_t size) {
+		const int64_t now = live_bytes.fetch_add((int64_t)size, std::memory_order_relaxed) + (int64_t)size;
+
+		size_t peak = peak_bytes.load(std::memory_order_relaxed);
+		while ((size_t)now > peak && !peak_bytes.compare_exchange_weak(peak, (size_t)now, std::memory_order_relaxed)) {}
+
+		record();
+	}
+
+	void freed(size_t size, uint64_t allocation_generation) {
+		if (allocation_generation != generation.load(std::memory_order_relaxed)) return;
+		live_bytes.fetch_sub((int64_t)size, std::memory_order_relaxed);
+		record();
+	}
+
+private:
+	static constexpr size_t SampleCapacity = 1 << 14;
+
+	// Only the thread that started the run samples, which keeps the ring single producer. Worker threads still count
+	// towards the live bytes and the peak.
 	void record() {
-		if (!running || internalPush) return;
+		if (!t_MemoryTracking.sampler) return;
 		auto now = std::chrono::steady_clock::now();
 		float elapsed_ms = std::chrono::duration<float, std::milli>(now - last_sample_time).count();
 		if (elapsed_ms >= interval_ms) {
 			last_sample_time = now;
-			std::lock_guard<std::mutex> guard(mutex);
-			internalPush = true;
-			samples.push_back(cumulative_allocated);
-			internalPush = false;
+			samples.push(live());
 		}
 	}
 
-	static std::atomic<size_t> total_allocated;
-	size_t cumulative_allocated{ 0 };
+	void drain(std::vector<size_t>& out) {
+		size_t sample = 0;
+		while (samples.pop(sample))
+			out.push_back(sample);
+	}
 
-private:
-	std::vector<size_t> samples;
-	std::mutex mutex;
+	// A free on another thread can briefly run ahead of the matching allocation's count
+	size_t live() const {
+		const int64_t bytes = live_bytes.load(std::memory_order_relaxed);
+		return bytes > 0 ? (size_t)bytes : 0;
+	}
+
+	SpscRing<size_t, SampleCapacity> samples;
 	std::chrono::steady_clock::time_point start_time;
 	std::chrono::steady_clock::time_point last_sample_time;
 	float interval_ms{ 10.0f }; // default 10ms
-	bool running{ false };
-	bool internalPush{ false };
+	std::atomic<int64_t> live_bytes{ 0 };
+	std::atomic<size_t> peak_bytes{ 0 };
+	std::atomic<uint64_t> generation{ 0 };
+};
+
+// Makes the calling worker thread's allocations count towards the tracked run of the thread that handed it a task, for
+// the lifetime of the scope. Thread pools capture t_MemoryTracking.tracker when work is submitted and open one of these
+// around the task.
+class MemoryTrackingWorkerScope {
+public:
+	explicit MemoryTrackingWorkerScope(MemoryTracker* tracker)
+		: previous(t_MemoryTracking) {
+		t_MemoryTracking = { tracker, false };
+	}
+
+	~MemoryTrackingWorkerScope() { t_MemoryTracking = previous; }
+
+	MemoryTrackingWorkerScope(const MemoryTrackingWorkerScope&) = delete;
+	MemoryTrackingWorkerScope& operator=(const MemoryTrackingWorkerScope&) = delete;
+
+private:
+	MemoryTrackingThreadState previous;
 };
 
 // Global instance
 extern MemoryTracker g_MemoryTracker;
 
-// new/delete overloads
+// new/delete overloads, every block carries a small header with its size and the tracking generation it was allocated
+// in, so unsized deletes are accounted for too
 void* operator new(std::size_t sz);
-void operator delete(void* ptr, std::size_t sz) noexcept;
 void* operator new[](std::size_t sz);
+void operator delete(void* ptr) noexcept;
+void operator delete[](void* ptr) noexcept;
+void operator delete(void* ptr, std::size_t sz) noexcept;
 void operator delete[](void* ptr, std::size_t sz) noexcept;
+void* operator new(std::size_t sz, const std::nothrow_t&) noexcept;
+void* operator new[](std::size_t sz, const std::nothrow_t&) noexcept;
+void operator delete(void* ptr, const std::nothrow_t&) noexcept;
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept;
 
 #define START_MEMORY_TRACKING(interval) g_MemoryTracker.begin(0.01)
 #define END_MEMORY_TRACKING() g_MemoryTracker.end()
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MIN_PLUS_X86 1
+#include <immintrin.h>
+#else
+#define MIN_PLUS_X86 0
+#endif
+
+// GCC and Clang only emit AVX instructions in functions that ask for them, so the kernels can live in a build without
+// -mavx2 and be picked at run time. MSVC accepts the intrinsics anywhere.
+#if MIN_PLUS_X86 && (defined(__GNUC__) || defined(__clang__))
+#define MIN_PLUS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MIN_PLUS_TARGET(isa)
+#endif
+
+// Min-plus products on square tiles of a row major distance matrix, the building block of the blocked Floyd-Warshall.
+// Tiles are MinPlusTileSize floats wide and every row of the matrix starts on a 64 byte boundary.
+static constexpr size_t MinPlusTileSize = 64;
+
+// c[i][j] = min(c[i][j], a[i][k] + b[k][j]) for every k of the tile, in Floyd-Warshall order (k outermost) so c may be the
+// same tile as a or b, as it is for the diagonal tile and its row and column. Row k of b and column k of a are left as they
+// are by step k in all three cases (they meet the diagonal's zero), so row k is copied out first and the inner loop
+// vectorizes without aliasing checks. These are only O(n / tile) of the tiles.
+inline void MinPlusDependentTile(float* c, const float* a, const float* b, size_t stride)
+{
+	constexpr float infinity = std::numeric_limits<float>::infinity();
+
+	for (size_t k = 0; k < MinPlusTileSize; k++)
+	{
+		float bk[MinPlusTileSize];
+		for (size_t j = 0; j < MinPlusTileSize; j++)
+			bk[j] = b[k * stride + j];
+
+		for (size_t i = 0; i < MinPlusTileSize; i++)
+		{
+			const float aik = a[i * stride + k];
+			if (aik == infinity)
+				continue;
+
+			float* ci = c + i * stride;
+			for (size_t j = 0; j < MinPlusTileSize; j++)
+			{
+				const float candidate = aik + bk[j];
+				ci[j] = candidate < ci[j] ? candidate : ci[j];
+			}
+		}
+	}
+}
+
+using MinPlusKernel = void (*)(float* c, const float* a, const float* b, size_t stride);
+
+// Same product for a tile that is neither a nor b, so the loops can be reordered: one row of c stays in registers while
+// every k is folded into it. All the remaining tiles of a round are of this kind, this is where the time goes.
+
+inline void MinPlusIndependentTileScalar(float* c, const float* a, const float* b, size_t stride)
+{
+	constexpr float infinity = std::numeric_limits<float>::infinity();
+
+	for (size_t i = 0; i < MinPlusTileSize; i++)
+	{
+		float row[MinPlusTileSize];
+		float* ci = c + i * stride;
+		const float* ai = a + i * stride;
+
+		for (size_t j = 0; j < MinPlusTileSize; j++)
+			row[j] = ci[j];
+
+		for (size_t k = 0; k < MinPlusTileSize; k++)
+		{
+			const float aik = ai[k];
+			if (aik == infinity)
+				continue;
+
+			const float* bk = b + k * stride;
+			for (size_t j = 0; j < MinPlusTileSize; j++)
+			{
+				const float candidate = aik + bk[j];
+				row[j] = candidate < row[j] ? candidate : row[j];
+			}
+		}
+
+		for (size_t j = 0; j < MinPlusTileSize; j++)
+			ci[j] = row[j];
+	}
+}
+
+#if MIN_PLUS_X86
+MIN_PLUS_TARGET("avx2")
+inline void MinPlusIndependentTileAvx2(float* c, const float* a, const float* b, size_t stride)
+{
+	constexpr size_t Lanes = 8;
+	constexpr size_t Registers = MinPlusTileSize / Lanes;
+	constexpr float infinity = std::numeric_limits<float>::infinity();
+
+	for (size_t i = 0; i < MinPlusTileSize; i++)
+	{
+		float* ci = c + i * stride;
+		const float* ai = a + i * stride;
+
+		__m256 row[Registers];
+		for (size_t r = 0; r < Registers; r++)
+			row[r] = _mm256_load_ps(ci + r * Lanes);
+
+		for (size_t k = 0; k < MinPlusTileSize; k++)
+		{
+			if (ai[k] == infinity)
+				continue;
+
+			const __m256 aik = _mm256_set1_ps(ai[k]);
+			const float* bk = b + k * stride;
+			for (size_t r = 0; r < Registers; r++)
+				row[r] = _mm256_min_ps(row[r], _mm256_add_ps(aik, _mm256_load_ps(bk + r * Lanes)));
+		}
+
+		for (size_t r = 0; r < Registers; r++)
+			_mm256_store_ps(ci + r * Lanes, row[r]);
+	}
+}
+
+// Two rows of c at a time, so every row of b loaded from L1 is used twice
+MIN_PLUS_TARGET("avx512f")
+inline void MinPlusIndependentTileAvx512(float* c, const float* a, const float* b, size_t stride)
+{
+	constexpr size_t Lanes = 16;
+	constexpr size_t Registers = MinPlusTileSize / Lanes;
+	constexpr __mmask16 AllLanes = 0xFFFF;
+	constexpr float infinity = std::numeric_limits<float>::infinity();
+
+	for (size_t i = 0; i < MinPlusTileSize; i += 2)
+	{
+		float* c0 = c + i * stride;
+		float* c1 = c0 + stride;
+		const float* a0 = a + i * stride;
+		const float* a1 = a0 + stride;
+
+		__m512 row0[Registers];
+		__m512 row1[Registers];
+		for (size_t r = 0; r < Registers; r++)
+		{
+			row0[r] = _mm512_load_ps(c0 + r * Lanes);
+			row1[r] = _mm512_load_ps(c1 + r * Lanes);
+		}
+
+		for (size_t k = 0; k < MinPlusTileSize; k++)
+		{
+			if (a0[k] == infinity && a1[k] == infinity)
+				continue;
+
+			const __m512 a0k = _mm512_set1_ps(a0[k]);
+			const __m512 a1k = _mm512_set1_ps(a1[k]);
+			const float* bk = b + k * stride;
+
+			// The masked min with every lane set is the same instruction, the unmasked intrinsic trips a false
+			// -Wuninitialized in GCC's headers
+			for (size_t r = 0; r < Registers; r++)
+			{
+				const __m512 bkr = _mm512_load_ps(bk + r * Lanes);
+				row0[r] = _mm512_mask_min_ps(row0[r], AllLanes, row0[r], _mm512_add_ps(a0k, bkr));
+				row1[r] = _mm512_mask_min_ps(row1[r], AllLanes, row1[r], _mm512_add_ps(a1k, bkr));
+			}
+		}
+
+		for (size_t r = 0; r < Registers; r++)
+		{
+			_mm512_store_ps(c0 + r * Lanes, row0[r]);
+			_mm512_store_ps(c1 + r * Lanes, row1[r]);
+		}
+	}
+}
+#endif
+
+// Widest kernel the CPU supports, checked once
+inline MinPlusKernel GetMinPlusKernel(const char** name = nullptr)
+{
+	static const auto selected = []()
+	{
+#if MIN_PLUS_X86 && (defined(__GNUC__) || defined(__clang__))
+		if (__builtin_cpu_supports("avx512f"))
+			return std::make_pair((MinPlusKernel)MinPlusIndependentTileAvx512, "AVX-512");
+		if (__builtin_cpu_supports("avx2"))
+			return std::make_pair((MinPlusKernel)MinPlusIndependentTileAvx2, "AVX2");
+		return std::make_pair((MinPlusKernel)MinPlusIndependentTileScalar, "Scalar");
+#elif MIN_PLUS_X86 && defined(__AVX512F__)
+		return std::make_pair((MinPlusKernel)MinPlusIndependentTileAvx512, "AVX-512");
+#elif MIN_PLUS_X86 && defined(__AVX2__)
+		return std::make_pair((MinPlusKernel)MinPlusIndependentTileAvx2, "AVX2");
+#else
+		return std::make_pair((MinPlusKernel)MinPlusIndependentTileScalar, "Scalar");
+#endif
+	}();
+
+	if (name)
+		*name = selected.second;
+
+	return selected.first;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "hardware_counters.hpp"
+#include "memory_tracker.hpp"
+
+// Number of workers to use when the caller doesn't ask for a specific count
+inline unsigned GetDefaultThreadCount()
+{
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Calls fn(index) for every index in [0, count) across thread_count threads (0 picks the default).
+// Indices are handed out one at a time, so uneven work such as one search per landmark still balances.
+// Allocations of the helper threads count towards the caller's tracked memory, if it is tracking.
+template <typename Fn>
+void ParallelFor(size_t count, unsigned thread_count, Fn&& fn)
+{
+	if (thread_count == 0)
+		thread_count = GetDefaultThreadCount();
+	thread_count = (unsigned)std::min<size_t>(thread_count, count);
+
+	if (thread_count <= 1)
+	{
+		for (size_t index = 0; index < count; index++)
+			fn(index);
+		return;
+	}
+
+	std::atomic<size_t> next{ 0 };
+	auto worker = [&]()
+	{
+		for (size_t index = next++; index < count; index = next++)
+			fn(index);
+	};
+
+	MemoryTracker* tracker = t_MemoryTracking.tracker;
+	auto helper = [&]()
+	{
+		MemoryTrackingWorkerScope tracking(tracker);
+		worker();
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count - 1);
+	for (unsigned thread = 1; thread < thread_count; thread++)
+		threads.emplace_back(helper);
+
+	worker();
+
+	for (auto& thread : threads)
+		thread.join();
+}
+
+// Worker threads that stay alive between calls, for algorithms that fork and join many times per query (once per bucket
+// or frontier level) where starting threads every time would cost more than the work in between.
+// Workers spin for a short while after each call so back to back steps don't pay for a wake up, then go to sleep.
+class ThreadTeam
+{
+public:
+	// thread_count includes the calling thread, 0 picks the default
+	explicit ThreadTeam(unsigned thread_count = 0)
+	{
+		m_ThreadCount = thread_count == 0 ? GetDefaultThreadCount() : thread_count;
+
+		m_Workers.reserve(m_ThreadCount - 1);
+		for (unsigned index = 1; index < m_ThreadCount; index++)
+			m_Workers.emplace_back([this, index]() { WorkerLoop(index); });
+	}
+
+	~ThreadTeam()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stop = true;
+		}
+		m_Wake.notify_all();
+
+		for (auto& worker : m_Workers)
+			worker.join();
+	}
+
+	ThreadTeam(const ThreadTeam&) = delete;
+	ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+	inline unsigned GetThreadCount() const { return m_ThreadCount; }
+
+	// Calls fn(thread_index) once on every thread of the team, the caller being index 0, and returns when all are done.
+	// The workers' allocations count towards the caller's tracked memory while they run fn, and their CPU events towards
+	// the caller's hardware counters.
+	template <typename Fn>
+	void Run(Fn&& fn)
+	{
+		if (m_ThreadCount == 1)
+		{
+			fn(0u);
+			return;
+		}
+
+		m_Task = [](void* context, unsigned index) { (*static_cast<std::remove_reference_t<Fn>*>(context))(index); };
+		m_Context = (void*)&fn;
+		m_Tracker = t_MemoryTracking.tracker;
+		m_Counting = t_HardwareCounting;
+		m_Remaining.store(m_ThreadCount - 1);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Generation.fetch_add(1);
+		}
+		m_Wake.notify_all();
+
+		fn(0u);
+
+		while (m_Remaining.load() != 0)
+			std::this_thread::yield();
+	}
+
+private:
+	static constexpr int SpinLimit = 4096;
+
+	void WorkerLoop(unsigned index)
+	{
+		unsigned seen = 0;
+		while (true)
+		{
+			unsigned generation = m_Generation.load();
+			for (int spin = 0; generation == seen && spin < SpinLimit; spin++)
+			{
+				std::this_thread::yield();
+				generation = m_Generation.load();
+			}
+
+			if (generation == seen)
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Wake.wait(lock, [&]() { return m_Stop || m_Generation.load() != seen; });
+				generation = m_Generation.load();
+			}
+
+			if (m_Stop)
+				return;
+
+			seen = generation;
+			if (m_Counting)
+				m_Counting->AttachCurrentThread();
+
+			{
+				MemoryTrackingWorkerScope tracking(m_Tracker);
+				m_Task(m_Context, index);
+			}
+			m_Remaining.fetch_sub(1);
+		}
+	}
+
+	unsigned m_ThreadCount = 1;
+	std::vector<std::thread> m_Workers;
+
+	void (*m_Task)(void*, unsigned) = nullptr;
+	void* m_Context = nullptr;
+	MemoryTracker* m_Tracker = nullptr;
+	HardwareCounterGroup* m_Counting = nullptr;
+
+	std::atomic<unsigned> m_Generation{ 0 };
+	std::atomic<unsigned> m_Remaining{ 0 };
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Wake;
+	std::atomic<bool> m_Stop{ false };
+};
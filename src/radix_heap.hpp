@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+// Monotone radix heap over unsigned 64 bit keys: a popped key may never be smaller than the previous one, which holds for
+// Dijkstra with non-negative integer weights. Entry (key, value) sits in the bucket numbered by the highest bit in which
+// key differs from the last popped key, so every entry moves to a lower bucket at most 64 times over its lifetime and
+// push/pop are amortized O(1) instead of O(log n).
+template <typename Value>
+class RadixHeap
+{
+public:
+	using Key = uint64_t;
+
+	RadixHeap() { Clear(); }
+
+	void Clear()
+	{
+		for (auto& bucket : m_Buckets)
+			bucket.clear();
+
+		m_Last = 0;
+		m_Size = 0;
+	}
+
+	inline bool Empty() const { return m_Size == 0; }
+	inline size_t Size() const { return m_Size; }
+
+	// key must be at least the last popped key
+	void Push(Key key, Value value)
+	{
+		m_Buckets[BucketIndex(key)].emplace_back(key, value);
+		m_Size++;
+	}
+
+	std::pair<Key, Value> Pop()
+	{
+		if (m_Buckets[0].empty())
+		{
+			size_t index = 1;
+			while (m_Buckets[index].empty())
+				index++;
+
+			// The smallest key in the first non-empty bucket becomes the new reference, every other entry of that
+			// bucket now differs from it in a lower bit and moves down
+			Key smallest = std::numeric_limits<Key>::max();
+			for (const auto& entry : m_Buckets[index])
+				smallest = entry.first < smallest ? entry.first : smallest;
+
+			m_Last = smallest;
+			for (const auto& entry : m_Buckets[index])
+				m_Buckets[BucketIndex(entry.first)].push_back(entry);
+
+			m_Buckets[index].clear();
+		}
+
+		const std::pair<Key, Value> top = m_Buckets[0].back();
+		m_Buckets[0].pop_back();
+		m_Size--;
+		return top;
+	}
+
+private:
+	static constexpr size_t BucketCount = 65;
+
+	inline size_t BucketIndex(Key key) const
+	{
+		const Key difference = key ^ m_Last;
+		return difference == 0 ? 0 : 64 - (size_t)CountLeadingZeros(difference);
+	}
+
+	static inline int CountLeadingZeros(Key x)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_clzll(x);
+#else
+		int count = 0;
+		for (Key bit = Key(1) << 63; (x & bit) == 0; bit >>= 1)
+			count++;
+		return count;
+#endif
+	}
+
+	std::vector<std::pair<Key, Value>> m_Buckets[BucketCount];
+	Key m_Last = 0;
+	size_t m_Size = 0;
+};
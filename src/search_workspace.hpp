@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Per-query scratch that algorithms keep as members and reuse, so repeated queries on a graph of the same size run
+// without touching the allocator once the first query has sized everything. Containers here only ever clear, never
+// shrink, and the per-vertex state resets in O(1) by starting a new epoch instead of refilling V entries.
+
+// Set of ids in [0, size). Every id carries the epoch it was inserted in and only the current epoch counts, so Reset
+// empties the set by bumping the epoch. The stamps are really cleared only when the 32 bit epoch wraps around.
+class EpochMarks
+{
+public:
+	void Reset(int size)
+	{
+		m_Stamps.resize(size);
+		if (++m_Epoch == 0)
+		{
+			std::fill(m_Stamps.begin(), m_Stamps.end(), 0);
+			m_Epoch = 1;
+		}
+	}
+
+	inline bool Contains(int id) const { return m_Stamps[id] == m_Epoch; }
+	inline void Insert(int id) { m_Stamps[id] = m_Epoch; }
+
+private:
+	std::vector<uint32_t> m_Stamps;
+	uint32_t m_Epoch = 0;
+};
+
+// Values for the ids in [0, size) where every id not set in the current epoch reads as the default given to Reset.
+// The stamp sits next to the value so a lookup touches a single cache line.
+template <typename T>
+class EpochArray
+{
+public:
+	void Reset(int size, const T& value)
+	{
+		m_Default = value;
+		m_Slots.resize(size);
+		if (++m_Epoch == 0)
+		{
+			for (Slot& slot : m_Slots)
+				slot.Epoch = 0;
+			m_Epoch = 1;
+		}
+	}
+
+	inline bool IsSet(int id) const { return m_Slots[id].Epoch == m_Epoch; }
+
+	inline T Get(int id) const
+	{
+		const Slot& slot = m_Slots[id];
+		return slot.Epoch == m_Epoch ? slot.Value : m_Default;
+	}
+
+	inline void Set(int id, const T& value) { m_Slots[id] = { value, m_Epoch }; }
+
+private:
+	struct Slot
+	{
+		T Value{};
+		uint32_t Epoch = 0;
+	};
+
+	std::vector<Slot> m_Slots;
+	T m_Default{};
+	uint32_t m_Epoch = 0;
+};
+
+// Tentative distance and the arc each vertex was reached over, for the single source searches. Unreached vertices
+// read as the infinity given to Reset with no parent.
+template <typename Distance>
+class SearchTree
+{
+public:
+	void Reset(int vertex_count, Distance infinity) { m_Labels.Reset(vertex_count, { infinity, -1, -1 }); }
+
+	// Whether v got a distance in this query
+	inline bool IsReached(int v) const { return m_Labels.IsSet(v); }
+
+	inline Distance GetDistance(int v) const { return m_Labels.Get(v).Dist; }
+	inline int GetParent(int v) const { return m_Labels.Get(v).Parent; }
+	inline int GetParentEdge(int v) const { return m_Labels.Get(v).ParentEdge; }
+
+	inline void Update(int v, Distance distance, int parent, int parent_edge) { m_Labels.Set(v, { distance, parent, parent_edge }); }
+
+	// Appends the edges from v back to the root of the tree, v's own edge first
+	void AppendEdgesToRoot(int v, std::vector<int>& edges) const
+	{
+		for (Label label = m_Labels.Get(v); label.Parent != -1; label = m_Labels.Get(label.Parent))
+			edges.push_back(label.ParentEdge);
+	}
+
+	// Replaces edges with the path from the root to v
+	void GetPathTo(int v, std::vector<int>& edges) const
+	{
+		edges.clear();
+		AppendEdgesToRoot(v, edges);
+		std::reverse(edges.begin(), edges.end());
+	}
+
+private:
+	struct Label
+	{
+		Distance Dist;
+		int Parent;
+		int ParentEdge;
+	};
+
+	EpochArray<Label> m_Labels;
+};
+
+// Binary min-heap on a vector that is kept between queries, the same heap operations std::priority_queue with
+// std::greater uses so entries come out in the same order
+template <typename T>
+class MinQueue
+{
+public:
+	inline void Clear() { m_Heap.clear(); }
+	inline bool Empty() const { return m_Heap.empty(); }
+	inline size_t Size() const { return m_Heap.size(); }
+	inline const T& Top() const { return m_Heap.front(); }
+
+	void Push(const T& value)
+	{
+		m_Heap.push_back(value);
+		std::push_heap(m_Heap.begin(), m_Heap.end(), std::greater<T>());
+	}
+
+	void Pop()
+	{
+		std::pop_heap(m_Heap.begin(), m_Heap.end(), std::greater<T>());
+		m_Heap.pop_back();
+	}
+
+private:
+	std::vector<T> m_Heap;
+};
+
+// Double ended queue of ints in a ring of fixed capacity, for label correcting searches that keep every vertex in
+// the queue at most once. Pushing past the capacity is not checked.
+class BoundedDeque
+{
+public:
+	void Reset(int capacity)
+	{
+		m_Ring.resize(std::max(capacity, 1));
+		m_Head = 0;
+		m_Size = 0;
+	}
+
+	inline bool Empty() const { return m_Size == 0; }
+	inline size_t Size() const { return m_Size; }
+	inline int Front() const { return m_Ring[m_Head]; }
+
+	inline void PushBack(int value)
+	{
+		m_Ring[Wrap(m_Head + m_Size)] = value;
+		m_Size++;
+	}
+
+	inline void PushFront(int value)
+	{
+		m_Head = Wrap(m_Head + m_Ring.size() - 1);
+		m_Ring[m_Head] = value;
+		m_Size++;
+	}
+
+	inline void PopFront()
+	{
+		m_Head = Wrap(m_Head + 1);
+		m_Size--;
+	}
+
+private:
+	// index is below twice the capacity
+	inline size_t Wrap(size_t index) const { return index >= m_Ring.size() ? index - m_Ring.size() : index; }
+
+	std::vector<int> m_Ring;
+	size_t m_Head = 0;
+	size_t m_Size = 0;
+};
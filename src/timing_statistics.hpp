@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstddef>
+
+// Summary of repeated timing samples, all values are in the unit of the samples (nanoseconds throughout the project)
+struct TimingStatistics
+{
+	size_t Samples = 0;
+	double Min = 0.0;
+	double Max = 0.0;
+	double Mean = 0.0;
+	double Median = 0.0;
+	double P95 = 0.0;
+	double StdDev = 0.0;
+};
+
+inline TimingStatistics ComputeTimingStatistics(std::vector<double> samples)
+{
+	TimingStatistics stats;
+	if (samples.empty())
+		return stats;
+
+	std::sort(samples.begin(), samples.end());
+
+	const size_t count = samples.size();
+	stats.Samples = count;
+	stats.Min = samples.front();
+	stats.Max = samples.back();
+	stats.Mean = std::accumulate(samples.begin(), samples.end(), 0.0) / (double)count;
+	stats.Median = (count % 2 == 1) ? samples[count / 2] : 0.5 * (samples[count / 2 - 1] + samples[count / 2]);
+
+	// Nearest-rank percentile
+	const size_t rank = (size_t)std::ceil(0.95 * (double)count);
+	stats.P95 = samples[std::min(count, std::max<size_t>(rank, 1)) - 1];
+
+	double variance = 0.0;
+	for (const double sample : samples)
+		variance += (sample - stats.Mean) * (sample - stats.Mean);
+	stats.StdDev = count > 1 ? std::sqrt(variance / (double)(count - 1)) : 0.0;
+
+	return stats;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Traversal log of a recorded search, compact enough for label correcting searches that relax the same edges over and
+// over (Bellman-Ford or D'Esopo-Pape can log O(V E) relaxations on adversarial graphs).
+// Every call to Record is a step, but only the first step that touches an edge is stored: the playback shows an edge from
+// its first traversal on, and keeping the step numbers keeps the pacing of the full log. The (step, edge) pairs are delta
+// encoded against the previous pair, the edge delta zigzag encoded since it can be negative, and written as LEB128
+// varints, so memory and decoding are proportional to the edges touched instead of the relaxations.
+class TraversalLog
+{
+public:
+	// Empties the log, the storage is kept for the next recording
+	void Clear()
+	{
+		if (m_Steps == 0)
+			return;
+
+		m_Bytes.clear();
+		std::fill(m_Seen.begin(), m_Seen.end(), 0);
+		m_Steps = 0;
+		m_Edges = 0;
+		m_LastStep = 0;
+		m_LastEdge = 0;
+	}
+
+	// edge_index must not be negative
+	void Record(int edge_index)
+	{
+		const uint64_t step = m_Steps++;
+
+		const size_t word = (size_t)edge_index / 64;
+		const uint64_t bit = (uint64_t)1 << ((size_t)edge_index % 64);
+		if (word >= m_Seen.size())
+			m_Seen.resize(word + 1, 0);
+
+		if ((m_Seen[word] & bit) != 0)
+			return;
+		m_Seen[word] |= bit;
+
+		const int64_t edgeDelta = (int64_t)edge_index - m_LastEdge;
+		WriteVarint(step - m_LastStep);
+		WriteVarint(((uint64_t)edgeDelta << 1) ^ (uint64_t)(edgeDelta >> 63));
+
+		m_LastStep = step;
+		m_LastEdge = edge_index;
+		m_Edges++;
+	}
+
+	// Calls fn(edge_index, step) for every edge in the order they were first touched
+	template <typename Fn>
+	void ForEachFirstTouch(Fn&& fn) const
+	{
+		uint64_t step = 0;
+		int64_t edge = 0;
+
+		for (size_t position = 0; position < m_Bytes.size(); )
+		{
+			step += ReadVarint(position);
+
+			const uint64_t zigzag = ReadVarint(position);
+			edge += (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+
+			fn((int)edge, (size_t)step);
+		}
+	}
+
+	// Every recorded step, including the ones that touched an edge again
+	inline size_t GetStepCount() const { return (size_t)m_Steps; }
+
+	// Distinct edges touched
+	inline size_t GetEdgeCount() const { return m_Edges; }
+
+	inline bool Empty() const { return m_Steps == 0; }
+
+	// Memory held by the encoded pairs and the touched edge bitmap
+	inline size_t GetMemoryBytes() const { return m_Bytes.capacity() + m_Seen.capacity() * sizeof(uint64_t); }
+
+private:
+	void WriteVarint(uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			m_Bytes.push_back((uint8_t)(value | 0x80));
+			value >>= 7;
+		}
+		m_Bytes.push_back((uint8_t)value);
+	}
+
+	uint64_t ReadVarint(size_t& position) const
+	{
+		uint64_t value = 0;
+		for (int shift = 0; ; shift += 7)
+		{
+			const uint8_t byte = m_Bytes[position++];
+			value |= (uint64_t)(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+	}
+
+	std::vector<uint8_t> m_Bytes;
+	std::vector<uint64_t> m_Seen;
+	uint64_t m_Steps = 0;
+	size_t m_Edges = 0;
+	uint64_t m_LastStep = 0;
+	int64_t m_LastEdge = 0;
+};